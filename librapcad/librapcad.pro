@@ -22,7 +22,10 @@
 #
 #-------------------------------------------------
 
-QT       -= core gui
+#The library has only the parser and evaluator, none of the user interface
+include(../rapcad.pri)
+
+QT	-= gui
 
 TARGET = rapcad
 TEMPLATE = lib
@@ -32,4 +35,12 @@ DEFINES += LIBRAPCAD_LIBRARY
 SOURCES += rapcad.cpp
 
 HEADERS += rapcad.h\
-        librapcad_global.h
+	librapcad_global.h
+
+unix {
+	isEmpty(PREFIX) {
+		PREFIX = /usr
+	}
+	INSTALLS += target
+	target.path = $$PREFIX/lib
+}
@@ -16,9 +16,208 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QMutex>
+#include <QTextStream>
 #include "rapcad.h"
+#include "script.h"
+#include "reporter.h"
+#include "assignstatement.h"
+#include "treeevaluator.h"
+#include "nodededuplicator.h"
+#include "nodeevaluator.h"
+#include "builtincreator.h"
+#include "symboltable.h"
+#include "scriptcache.h"
+#include "registry.h"
+#include "diagnosticsink.h"
 
+#if USE_CGAL
+#include "CGAL/exceptions.h"
+#include "cgalexport.h"
+#endif
+
+extern Script* parse(QString,Reporter*,bool);
+
+static QMutex initLock;
+//CGAL is not safe to use from two threads at once
+static QMutex geometryLock;
 
 rapcad::rapcad()
 {
+	//The shared parts of the evaluator are created on first use, which
+	//must not happen in two threads at once.
+	QMutexLocker locker(&initLock);
+	SymbolTable::getInstance();
+	ScriptCache::getInstance();
+	BuiltinCreator::getInstance();
+}
+
+/**
+  Sets the variable to the value of the expression, which is written
+  in the same way as in a script, such as 10, "text" or [1,2,3].
+*/
+void rapcad::setParameter(QString name,QString expression)
+{
+	parameters.insert(name,expression);
+}
+
+void rapcad::clearParameters()
+{
+	parameters.clear();
+}
+
+bool rapcad::evaluateFile(QString path)
+{
+	return evaluate(path,true);
+}
+
+bool rapcad::evaluateText(QString text)
+{
+	return evaluate(text,false);
+}
+
+/**
+  Abandons the evaluation in progress, in which case it returns false.
+  This may be called from any thread.
+*/
+void rapcad::cancel()
+{
+	cancelled=1;
+}
+
+/**
+  The vertices as consecutive x, y and z coordinates.
+*/
+QVector<double> rapcad::getVertices() const
+{
+	return vertices;
+}
+
+/**
+  The triangles as consecutive triples of indices into the vertices.
+*/
+QVector<int> rapcad::getTriangles() const
+{
+	return triangles;
+}
+
+/**
+  The warnings, errors and echoed output of the last evaluation.
+*/
+QString rapcad::getMessages() const
+{
+	return messages;
+}
+
+/**
+  The warnings and errors of the last evaluation, each as a JSON object
+  in the same form as written by the -e option.
+*/
+QList<QString> rapcad::getDiagnostics() const
+{
+	return diagnostics;
+}
+
+/* Called between stages so that the warnings and echoed text are
+ * formatted in order, but not while evaluating. */
+void rapcad::takeDiagnostics(DiagnosticSink& sink,QTextStream& output)
+{
+	foreach(Diagnostic* d,sink.takeAll()) {
+		output << d->getMessage();
+		if(d->getCode()!=Diagnostic::Echo) {
+			output << "\n";
+			diagnostics.append(d->toJson());
+		}
+		delete d;
+	}
+}
+
+bool rapcad::evaluate(QString input,bool file)
+{
+	vertices.clear();
+	triangles.clear();
+	messages.clear();
+	diagnostics.clear();
+	cancelled=0;
+
+	QTextStream output(&messages);
+	DiagnosticSink sink;
+	Reporter reporter(output);
+	reporter.setDiagnostics(&sink);
+
+	//Everything the evaluation creates belongs to it alone
+	Registry<Value> values;
+	Registry<Node> nodes;
+	Registry<Value>* previousValues=Registry<Value>::attach(&values);
+	Registry<Node>* previousNodes=Registry<Node>::attach(&nodes);
+
+	QList<Script*> assignments;
+	QHash<QString,Expression*> expressions;
+	foreach(QString name,parameters.keys()) {
+		Script* a=parse(QString("%1=%2;").arg(name).arg(parameters.value(name)),&reporter,false);
+		assignments.append(a);
+		QList<Declaration*> decls=a->getDeclarations();
+		AssignStatement* stmt=decls.size()==1?dynamic_cast<AssignStatement*>(decls.first()):NULL;
+		if(stmt)
+			expressions.insert(name,stmt->getExpression());
+	}
+
+	Script* s=parse(input,&reporter,file);
+	takeDiagnostics(sink,output);
+	bool result=false;
+	if(reporter.getErrorCount()==0) {
+		TreeEvaluator e(output);
+		e.setParameters(expressions);
+		e.setDiagnostics(&sink);
+		s->accept(e);
+		takeDiagnostics(sink,output);
+		Node* n=e.getRootNode();
+
+		NodeDeduplicator d;
+		n=d.deduplicate(n);
+
+		geometryLock.lock();
+		NodeEvaluator ne(output);
+		ne.setReferences(d.getReferences());
+		ne.setCancelled(&cancelled);
+		ne.setDiagnostics(&sink);
+		bool stopped=false;
+		try {
+			ne.evaluate(n);
+		} catch(CancelledException) {
+			stopped=true;
+#if USE_CGAL
+		} catch(CGAL::Assertion_exception e) {
+			output << "What: " << QString::fromStdString(e.what()) << "\n";
+		}
+#else
+		} catch(...) {
+		}
+#endif
+		takeDiagnostics(sink,output);
+
+		Primitive* p=stopped?NULL:ne.getResult();
+#if USE_CGAL
+		CGALPrimitive* cp=dynamic_cast<CGALPrimitive*>(p);
+		if(cp) {
+			CGALExport exporter(cp);
+			exporter.exportMesh(vertices,triangles);
+			result=true;
+		}
+#endif
+		if(stopped)
+			output << "Rendering stopped.\n";
+		else if(!p)
+			output << "Warning: No top level object.\n";
+		delete p;
+		geometryLock.unlock();
+	}
+	delete s;
+	qDeleteAll(assignments);
+
+	Registry<Value>::attach(previousValues);
+	Registry<Node>::attach(previousNodes);
+
+	output.flush();
+	return result;
 }
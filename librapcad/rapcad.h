@@ -19,11 +19,49 @@
 #ifndef RAPCAD_H
 #define RAPCAD_H
 
+#include <QString>
+#include <QList>
+#include <QAtomicInt>
+#include <QHash>
+#include <QVector>
 #include "librapcad_global.h"
 
+class DiagnosticSink;
+class QTextStream;
+
+/**
+  Evaluates a script and gives the result as a mesh. Values given with
+  setParameter replace the expressions assigned to the variables of the
+  same name at the top level of the script, so that parametric variants
+  can be evaluated without changing the script.
+
+  Each instance should only be used by one thread at a time, but any
+  number of instances can evaluate at the same time. Their scripts are
+  evaluated in parallel, but the geometry of only one is built at a time
+  since CGAL is not thread safe. Only cancel may be called from another
+  thread.
+*/
 class LIBRAPCADSHARED_EXPORT rapcad {
 public:
-    rapcad();
+	rapcad();
+	void setParameter(QString,QString);
+	void clearParameters();
+	bool evaluateFile(QString);
+	bool evaluateText(QString);
+	void cancel();
+	QVector<double> getVertices() const;
+	QVector<int> getTriangles() const;
+	QString getMessages() const;
+	QList<QString> getDiagnostics() const;
+private:
+	bool evaluate(QString,bool);
+	void takeDiagnostics(DiagnosticSink&,QTextStream&);
+	QAtomicInt cancelled;
+	QHash<QString,QString> parameters;
+	QVector<double> vertices;
+	QVector<int> triangles;
+	QString messages;
+	QList<QString> diagnostics;
 };
 
 #endif // RAPCAD_H
@@ -0,0 +1,397 @@
+#-------------------------------------------------------------------------
+#	RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+#	Copyright (C) 2010-2013 Giles Bathgate
+#
+#	This program is free software: you can redistribute it and/or modify
+#	it under the terms of the GNU General Public License as published by
+#	the Free Software Foundation, either version 3 of the License, or
+#	(at your option) any later version.
+#
+#	This program is distributed in the hope that it will be useful,
+#	but WITHOUT ANY WARRANTY; without even the implied warranty of
+#	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#	GNU General Public License for more details.
+#
+#	You should have received a copy of the GNU General Public License
+#	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#-------------------------------------------------------------------------
+
+#The parser and evaluator, without any user interface. Shared by the
+#application and by librapcad, so paths are given relative to this file.
+
+VERSION = $$cat($$PWD/VERSION)
+
+LEXSOURCES += $$PWD/src/lexer.l
+YACCSOURCES += $$PWD/src/parser.y
+INCLUDEPATH += $$PWD/src
+
+win32 {
+	CGALROOT = "..\\CGAL-4.0\\"
+	BOOSTROOT = "..\\boost_1_49_0\\"
+	DXFLIBROOT = "..\\dxflib-2.2.0.0-1.src\\"
+	MINGWROOT = "..\\MinGW\\msys\\1.0\\bin\\"
+	INCLUDEPATH += $$CGALROOT"include"
+	INCLUDEPATH += $$CGALROOT"auxiliary\\gmp\\include"
+	INCLUDEPATH += $$DXFLIBROOT
+	INCLUDEPATH += $$BOOSTROOT
+	LIBS += -L$$BOOSTROOT"bin.v2\\libs\\thread\\build\\gcc-mingw-4.6.2\\release\\threading-multi"
+	LIBS += -llibboost_thread-mgw46-mt-1_49
+	LIBS += -L$$CGALROOT"lib" -lCGAL -lCGAL_Core
+	LIBS += -L$$CGALROOT"auxiliary\\gmp\\lib" -lmpfr-4 -lgmp-10
+	LIBS += -L$$DXFLIBROOT"lib" -llibdxf
+	LIBS += -lpsapi
+	QMAKE_YACC = $$MINGWROOT"bison"
+	QMAKE_YACCFLAGS += "-b y"
+	QMAKE_LEX = $$MINGWROOT"flex"
+	QMAKE_MOVE = $$MINGWROOT"mv"
+	QMAKE_DEL_FILE = $$MINGWROOT"rm -f"
+} else {
+	LIBS += -lCGAL -lCGAL_Core -lmpfr -lgmp -ldxflib
+	QMAKE_YACC = bison
+  macx {
+	INCLUDEPATH += /opt/local/include
+	LIBS += -L/opt/local/lib -lboost_thread-mt
+	QMAKE_MOC = $$[QT_INSTALL_BINS]\\moc -DBOOST_TT_HAS_OPERATOR_HPP_INCLUDED
+  } else {
+	LIBS += -lboost_thread
+  }
+}
+
+DEFINES+=USE_CGAL
+
+QMAKE_CXXFLAGS += -frounding-math
+
+CONFIG(official){
+	DEFINES += RAPCAD_VERSION=$$VERSION
+} else {
+	MAJOR=$$system(cut -d'.' -f1 $$PWD/VERSION)
+	MINOR=$$system(cut -d'.' -f2 $$PWD/VERSION)
+	DEFINES += RAPCAD_VERSION=$$MAJOR"."$$MINOR".git."$$system(git log -1 --pretty=format:%h)
+}
+
+SOURCES += \
+	$$PWD/src/module.cpp \
+	$$PWD/src/syntaxtreebuilder.cpp \
+	$$PWD/src/parameter.cpp \
+	$$PWD/src/expression.cpp \
+	$$PWD/src/binaryexpression.cpp \
+	$$PWD/src/literal.cpp \
+	$$PWD/src/variable.cpp \
+	$$PWD/src/declaration.cpp \
+	$$PWD/src/scope.cpp \
+	$$PWD/src/modulescope.cpp \
+	$$PWD/src/dependencybuilder.cpp \
+	$$PWD/src/instance.cpp \
+	$$PWD/src/argument.cpp \
+	$$PWD/src/statement.cpp \
+	$$PWD/src/function.cpp \
+	$$PWD/src/functionscope.cpp \
+	$$PWD/src/compoundstatement.cpp \
+	$$PWD/src/assignstatement.cpp \
+	$$PWD/src/vectorexpression.cpp \
+	$$PWD/src/ifelsestatement.cpp \
+	$$PWD/src/forstatement.cpp \
+	$$PWD/src/rangeexpression.cpp \
+	$$PWD/src/unaryexpression.cpp \
+	$$PWD/src/invocation.cpp \
+	$$PWD/src/returnstatement.cpp \
+	$$PWD/src/ternaryexpression.cpp \
+	$$PWD/src/moduleimport.cpp \
+	$$PWD/src/treeprinter.cpp \
+	$$PWD/src/script.cpp \
+	$$PWD/src/tokenbuilder.cpp \
+	$$PWD/src/treeevaluator.cpp \
+	$$PWD/src/context.cpp \
+	$$PWD/src/value.cpp \
+	$$PWD/src/module/echomodule.cpp \
+	$$PWD/src/numbervalue.cpp \
+	$$PWD/src/booleanvalue.cpp \
+	$$PWD/src/textvalue.cpp \
+	$$PWD/src/vectorvalue.cpp \
+	$$PWD/src/rangevalue.cpp \
+	$$PWD/src/valueiterator.cpp \
+	$$PWD/src/vectoriterator.cpp \
+	$$PWD/src/rangeiterator.cpp \
+	$$PWD/src/scriptimport.cpp \
+	$$PWD/src/node/primitivenode.cpp \
+	$$PWD/src/module/cubemodule.cpp \
+	$$PWD/src/module/differencemodule.cpp \
+	$$PWD/src/module/polyhedronmodule.cpp \
+	$$PWD/src/module/cylindermodule.cpp \
+	$$PWD/src/module/primitivemodule.cpp \
+	$$PWD/src/node.cpp \
+	$$PWD/src/node/transformationnode.cpp \
+	$$PWD/src/point.cpp \
+	$$PWD/src/nodeprinter.cpp \
+	$$PWD/src/nodeevaluator.cpp \
+	$$PWD/src/cgalbuilder.cpp \
+	$$PWD/src/node/differencenode.cpp \
+	$$PWD/src/node/unionnode.cpp \
+	$$PWD/src/module/unionmodule.cpp \
+	$$PWD/src/module/intersectionmodule.cpp \
+	$$PWD/src/node/intersectionnode.cpp \
+	$$PWD/src/module/translatemodule.cpp \
+	$$PWD/src/module/symmetricdifferencemodule.cpp \
+	$$PWD/src/node/symmetricdifferencenode.cpp \
+	$$PWD/src/cgalprimitive.cpp \
+	$$PWD/src/module/squaremodule.cpp \
+	$$PWD/src/module/circlemodule.cpp \
+	$$PWD/src/module/minkowskimodule.cpp \
+	$$PWD/src/node/minkowskinode.cpp \
+	$$PWD/src/module/rotatemodule.cpp \
+	$$PWD/src/module/mirrormodule.cpp \
+	$$PWD/src/module/scalemodule.cpp \
+	$$PWD/src/module/childmodule.cpp \
+	$$PWD/src/module/spheremodule.cpp \
+	$$PWD/src/reporter.cpp \
+	$$PWD/src/codedoc.cpp \
+	$$PWD/src/dxfbuilder.cpp \
+	$$PWD/src/module/shearmodule.cpp \
+	$$PWD/src/module/groupmodule.cpp \
+	$$PWD/src/cgalexplorer.cpp \
+	$$PWD/src/module/hullmodule.cpp \
+	$$PWD/src/node/hullnode.cpp \
+	$$PWD/src/module/linearextrudemodule.cpp \
+	$$PWD/src/node/linearextrudenode.cpp \
+	$$PWD/src/module/boundsmodule.cpp \
+	$$PWD/src/node/boundsnode.cpp \
+	$$PWD/src/module/subdivisionmodule.cpp \
+	$$PWD/src/node/subdivisionnode.cpp \
+	$$PWD/src/module/offsetmodule.cpp \
+	$$PWD/src/node/offsetnode.cpp \
+	$$PWD/src/module/polylinemodule.cpp \
+	$$PWD/src/node/polylinenode.cpp \
+	$$PWD/src/module/glidemodule.cpp \
+	$$PWD/src/node/glidenode.cpp \
+	$$PWD/src/cgalpolygon.cpp \
+	$$PWD/src/module/beziersurfacemodule.cpp \
+	$$PWD/src/cgalexport.cpp \
+	$$PWD/src/module/prismmodule.cpp \
+	$$PWD/src/function/sqrtfunction.cpp \
+	$$PWD/src/function/sumfunction.cpp \
+	$$PWD/src/function/randfunction.cpp \
+	$$PWD/src/module/cylindersurfacemodule.cpp \
+	$$PWD/src/module/outlinemodule.cpp \
+	$$PWD/src/node/outlinenode.cpp \
+	$$PWD/src/module/importmodule.cpp \
+	$$PWD/src/builtincreator.cpp \
+	$$PWD/src/node/importnode.cpp \
+	$$PWD/src/cgalimport.cpp \
+	$$PWD/src/module/resizemodule.cpp \
+	$$PWD/src/node/resizenode.cpp \
+	$$PWD/src/module/rotateextrudemodule.cpp \
+	$$PWD/src/node/rotateextrudenode.cpp \
+	$$PWD/src/function/versionfunction.cpp \
+	$$PWD/src/module/polygonmodule.cpp \
+	$$PWD/src/function/lengthfunction.cpp \
+	$$PWD/src/function/strfunction.cpp \
+	$$PWD/src/function/sinfunction.cpp \
+	$$PWD/src/function/cosfunction.cpp \
+	$$PWD/src/function/tanfunction.cpp \
+	$$PWD/src/function/absfunction.cpp \
+	$$PWD/src/function/signfunction.cpp \
+	$$PWD/src/function/minfunction.cpp \
+	$$PWD/src/function/maxfunction.cpp \
+	$$PWD/src/function/roundfunction.cpp \
+	$$PWD/src/function/ceilfunction.cpp \
+	$$PWD/src/function/floorfunction.cpp \
+	$$PWD/src/function/powfunction.cpp \
+	$$PWD/src/function/expfunction.cpp \
+	$$PWD/src/function/asinfunction.cpp \
+	$$PWD/src/function/acosfunction.cpp \
+	$$PWD/src/function/atan2function.cpp \
+	$$PWD/src/function/atanfunction.cpp \
+	$$PWD/src/function/coshfunction.cpp \
+	$$PWD/src/function/sinhfunction.cpp \
+	$$PWD/src/function/tanhfunction.cpp \
+	$$PWD/src/module/centermodule.cpp \
+	$$PWD/src/node/centernode.cpp \
+	$$PWD/src/module/pointmodule.cpp \
+	$$PWD/src/node/pointnode.cpp \
+	$$PWD/src/module/slicemodule.cpp \
+	$$PWD/src/node/slicenode.cpp \
+	$$PWD/src/module/conemodule.cpp \
+	$$PWD/src/function/lnfunction.cpp \
+	$$PWD/src/function/logfunction.cpp \
+	$$PWD/src/symboltable.cpp \
+	$$PWD/src/packedvectorvalue.cpp \
+	$$PWD/src/sideeffectchecker.cpp \
+	$$PWD/src/nodededuplicator.cpp \
+	$$PWD/src/node/instancenode.cpp \
+	$$PWD/src/random.cpp \
+	$$PWD/src/scriptcache.cpp \
+	$$PWD/src/scriptlibrary.cpp \
+	$$PWD/src/geometrycache.cpp \
+	$$PWD/src/nodeprofile.cpp \
+	$$PWD/src/diagnostic.cpp \
+	$$PWD/src/diagnosticsink.cpp
+
+HEADERS += \
+	$$PWD/src/module.h \
+	$$PWD/src/syntaxtreebuilder.h \
+	$$PWD/src/parameter.h \
+	$$PWD/src/expression.h \
+	$$PWD/src/binaryexpression.h \
+	$$PWD/src/literal.h \
+	$$PWD/src/variable.h \
+	$$PWD/src/declaration.h \
+	$$PWD/src/scope.h \
+	$$PWD/src/modulescope.h \
+	$$PWD/src/abstractsyntaxtreebuilder.h \
+	$$PWD/src/dependencybuilder.h \
+	$$PWD/src/instance.h \
+	$$PWD/src/argument.h \
+	$$PWD/src/statement.h \
+	$$PWD/src/function.h \
+	$$PWD/src/functionscope.h \
+	$$PWD/src/compoundstatement.h \
+	$$PWD/src/assignstatement.h \
+	$$PWD/src/vectorexpression.h \
+	$$PWD/src/ifelsestatement.h \
+	$$PWD/src/forstatement.h \
+	$$PWD/src/rangeexpression.h \
+	$$PWD/src/unaryexpression.h \
+	$$PWD/src/invocation.h \
+	$$PWD/src/returnstatement.h \
+	$$PWD/src/ternaryexpression.h \
+	$$PWD/src/moduleimport.h \
+	$$PWD/src/treevisitor.h \
+	$$PWD/src/treeprinter.h \
+	$$PWD/src/visitabletree.h \
+	$$PWD/src/script.h \
+	$$PWD/src/tokenbuilder.h \
+	$$PWD/src/abstracttokenbuilder.h \
+	$$PWD/src/treeevaluator.h \
+	$$PWD/src/context.h \
+	$$PWD/src/value.h \
+	$$PWD/src/module/echomodule.h \
+	$$PWD/src/tau.h \
+	$$PWD/src/numbervalue.h \
+	$$PWD/src/booleanvalue.h \
+	$$PWD/src/textvalue.h \
+	$$PWD/src/vectorvalue.h \
+	$$PWD/src/rangevalue.h \
+	$$PWD/src/iterator.h \
+	$$PWD/src/valueiterator.h \
+	$$PWD/src/vectoriterator.h \
+	$$PWD/src/rangeiterator.h \
+	$$PWD/src/scriptimport.h \
+	$$PWD/src/cgal.h \
+	$$PWD/src/node/primitivenode.h \
+	$$PWD/src/module/cubemodule.h \
+	$$PWD/src/module/differencemodule.h \
+	$$PWD/src/module/polyhedronmodule.h \
+	$$PWD/src/module/cylindermodule.h \
+	$$PWD/src/module/primitivemodule.h \
+	$$PWD/src/node.h \
+	$$PWD/src/node/transformationnode.h \
+	$$PWD/src/point.h \
+	$$PWD/src/nodevisitor.h \
+	$$PWD/src/visitablenode.h \
+	$$PWD/src/nodeprinter.h \
+	$$PWD/src/nodeevaluator.h \
+	$$PWD/src/polygon.h \
+	$$PWD/src/cgalbuilder.h \
+	$$PWD/src/node/differencenode.h \
+	$$PWD/src/node/unionnode.h \
+	$$PWD/src/module/unionmodule.h \
+	$$PWD/src/module/intersectionmodule.h \
+	$$PWD/src/node/intersectionnode.h \
+	$$PWD/src/module/translatemodule.h \
+	$$PWD/src/module/symmetricdifferencemodule.h \
+	$$PWD/src/node/symmetricdifferencenode.h \
+	$$PWD/src/cgalprimitive.h \
+	$$PWD/src/module/squaremodule.h \
+	$$PWD/src/module/circlemodule.h \
+	$$PWD/src/module/minkowskimodule.h \
+	$$PWD/src/node/minkowskinode.h \
+	$$PWD/src/module/rotatemodule.h \
+	$$PWD/src/module/mirrormodule.h \
+	$$PWD/src/module/scalemodule.h \
+	$$PWD/src/module/childmodule.h \
+	$$PWD/src/module/spheremodule.h \
+	$$PWD/src/reporter.h \
+	$$PWD/src/codedoc.h \
+	$$PWD/src/dxfbuilder.h \
+	$$PWD/src/module/shearmodule.h \
+	$$PWD/src/module/groupmodule.h \
+	$$PWD/src/cgalexplorer.h \
+	$$PWD/src/module/hullmodule.h \
+	$$PWD/src/node/hullnode.h \
+	$$PWD/src/module/linearextrudemodule.h \
+	$$PWD/src/node/linearextrudenode.h \
+	$$PWD/src/module/boundsmodule.h \
+	$$PWD/src/node/boundsnode.h \
+	$$PWD/src/module/subdivisionmodule.h \
+	$$PWD/src/node/subdivisionnode.h \
+	$$PWD/src/module/offsetmodule.h \
+	$$PWD/src/node/offsetnode.h \
+	$$PWD/src/module/polylinemodule.h \
+	$$PWD/src/node/polylinenode.h \
+	$$PWD/src/module/glidemodule.h \
+	$$PWD/src/node/glidenode.h \
+	$$PWD/src/cgalpolygon.h \
+	$$PWD/src/module/beziersurfacemodule.h \
+	$$PWD/src/cgalexport.h \
+	$$PWD/src/module/prismmodule.h \
+	$$PWD/src/function/sqrtfunction.h \
+	$$PWD/src/function/sumfunction.h \
+	$$PWD/src/function/randfunction.h \
+	$$PWD/src/module/cylindersurfacemodule.h \
+	$$PWD/src/module/outlinemodule.h \
+	$$PWD/src/node/outlinenode.h \
+	$$PWD/src/module/importmodule.h \
+	$$PWD/src/builtincreator.h \
+	$$PWD/src/node/importnode.h \
+	$$PWD/src/cgalimport.h \
+	$$PWD/src/module/resizemodule.h \
+	$$PWD/src/node/resizenode.h \
+	$$PWD/src/module/rotateextrudemodule.h \
+	$$PWD/src/node/rotateextrudenode.h \
+	$$PWD/src/function/versionfunction.h \
+	$$PWD/src/module/polygonmodule.h \
+	$$PWD/src/function/lengthfunction.h \
+	$$PWD/src/function/strfunction.h \
+	$$PWD/src/function/sinfunction.h \
+	$$PWD/src/function/cosfunction.h \
+	$$PWD/src/function/tanfunction.h \
+	$$PWD/src/function/absfunction.h \
+	$$PWD/src/function/signfunction.h \
+	$$PWD/src/function/minfunction.h \
+	$$PWD/src/function/maxfunction.h \
+	$$PWD/src/function/roundfunction.h \
+	$$PWD/src/function/ceilfunction.h \
+	$$PWD/src/function/floorfunction.h \
+	$$PWD/src/function/powfunction.h \
+	$$PWD/src/function/expfunction.h \
+	$$PWD/src/function/asinfunction.h \
+	$$PWD/src/function/acosfunction.h \
+	$$PWD/src/function/atan2function.h \
+	$$PWD/src/function/atanfunction.h \
+	$$PWD/src/function/coshfunction.h \
+	$$PWD/src/function/sinhfunction.h \
+	$$PWD/src/function/tanhfunction.h \
+	$$PWD/src/module/centermodule.h \
+	$$PWD/src/node/centernode.h \
+	$$PWD/src/module/pointmodule.h \
+	$$PWD/src/node/pointnode.h \
+	$$PWD/src/module/slicemodule.h \
+	$$PWD/src/node/slicenode.h \
+	$$PWD/src/primitive.h \
+	$$PWD/src/module/conemodule.h \
+	$$PWD/src/function/lnfunction.h \
+	$$PWD/src/function/logfunction.h \
+	$$PWD/src/symboltable.h \
+	$$PWD/src/packedvectorvalue.h \
+	$$PWD/src/sideeffectchecker.h \
+	$$PWD/src/nodededuplicator.h \
+	$$PWD/src/node/instancenode.h \
+	$$PWD/src/random.h \
+	$$PWD/src/scriptcache.h \
+	$$PWD/src/scriptlibrary.h \
+	$$PWD/src/registry.h \
+	$$PWD/src/geometrycache.h \
+	$$PWD/src/nodeprofile.h \
+	$$PWD/src/diagnostic.h \
+	$$PWD/src/diagnosticsink.h \
+	$$PWD/src/renderlistener.h
@@ -33,7 +33,6 @@ public:
 	void lineNumberAreaPaintEvent(QPaintEvent*);
 	int lineNumberAreaWidth();
 
-	void stopHighlighting();
 	void setFileName(const QString&);
 	QString getFileName();
 	bool saveFile();
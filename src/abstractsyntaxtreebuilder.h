@@ -31,10 +31,13 @@
 #include "script.h"
 #include "invocation.h"
 
+class AbstractTokenBuilder;
+
 class AbstractSyntaxTreeBuilder
 {
 public:
 	virtual ~AbstractSyntaxTreeBuilder() {}
+	virtual void setTokenizer(AbstractTokenBuilder*)=0;
 	virtual void buildScript(Declaration*)=0;
 	virtual void buildScript(QList<Declaration*>*)=0;
 	virtual void buildScript(QList<CodeDoc*>*)=0;
@@ -51,6 +54,9 @@ public:
 	virtual QList<Declaration*>* buildDeclarations(Declaration*)=0;
 	virtual QList<Declaration*>* buildDeclarations(QList<Declaration*>*)=0;
 	virtual QList<Declaration*>* buildDeclarations(QList<Declaration*>*,Declaration*)=0;
+	virtual QList<Declaration*>* buildInclude(Script*)=0;
+	virtual QList<Declaration*>* buildInclude(QList<Declaration*>*,Script*)=0;
+	virtual void buildIncludes(QList<QString>)=0;
 	virtual Statement* buildStatement(Statement*)=0;
 	virtual Statement* buildStatement(Variable*,Expression::Operator_e)=0;
 	virtual Statement* buildStatement(Variable*,Expression::Operator_e,Expression*)=0;
@@ -30,10 +30,11 @@ public:
 	virtual int nextToken()=0;
 	virtual int getPosition() const=0;
 	virtual int getLineNumber() const=0;
+	virtual QString getFileName() const=0;
 	virtual void buildIncludeStart()=0;
 	virtual void buildIncludeFile(QString)=0;
 	virtual void buildIncludePath(QString)=0;
-	virtual void buildIncludeFinish()=0;
+	virtual unsigned int buildIncludeFinish()=0;
 	virtual void buildUseStart()=0;
 	virtual unsigned int buildUse(QString)=0;
 	virtual void buildUseFinish()=0;
@@ -22,8 +22,12 @@ BackgroundWorker::BackgroundWorker(QTextStream& s,QObject* parent) :
 	Worker(s,parent)
 {
 	print=false;
+	progressive=true;
+	detach=true;
 	thread=new QThread();
 	connect(thread,SIGNAL(started()),this,SLOT(doWork()));
+	//Passed on straight away since this object lives in the thread
+	connect(thread,SIGNAL(finished()),this,SIGNAL(finished()),Qt::DirectConnection);
 	this->moveToThread(thread);
 }
 
@@ -37,8 +41,13 @@ void BackgroundWorker::setup(QString f)
 	inputFile=f;
 }
 
+/**
+  Starts a render, which must not be done before the previous one has
+  finished, so that the caller never has to wait for the thread.
+*/
 void BackgroundWorker::evaluate()
 {
+	cancelled=0;
 	thread->start();
 }
 
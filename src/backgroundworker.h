@@ -30,6 +30,8 @@ public:
 	virtual ~BackgroundWorker();
 	void setup(QString);
 	void evaluate();
+signals:
+	void finished();
 private:
 	void finish();
 	QThread* thread;
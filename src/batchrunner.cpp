@@ -0,0 +1,218 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTime>
+#include "batchrunner.h"
+#include "batchworker.h"
+#include "builtincreator.h"
+#include "registry.h"
+#include "value.h"
+#include "node.h"
+
+/* Scripts are parsed and evaluated in parallel but the jobs take turns
+ * to compute their geometry, see Worker::setGeometryLock(). The geometry
+ * cache is only used while holding the lock, so the jobs share it and
+ * parts common to several scripts are only computed once. */
+static QMutex geometryLock;
+
+class BatchJob : public QRunnable
+{
+public:
+	BatchJob(BatchRunner*,GeometryCache*,int,QString,QString);
+	void run();
+private:
+	BatchRunner* runner;
+	GeometryCache* geometry;
+	int index;
+	QString inputFile;
+	QString outputFile;
+};
+
+BatchJob::BatchJob(BatchRunner* r,GeometryCache* g,int i,QString in,QString out)
+{
+	runner=r;
+	geometry=g;
+	index=i;
+	inputFile=in;
+	outputFile=out;
+}
+
+void BatchJob::run()
+{
+	QString text;
+	QTextStream s(&text);
+
+	Registry<Value> values;
+	Registry<Node> nodes;
+	Registry<Value>* previousValues=Registry<Value>::attach(&values);
+	Registry<Node>* previousNodes=Registry<Node>::attach(&nodes);
+
+	QTime t;
+	t.start();
+	BatchWorker w(s);
+	w.setup(inputFile,outputFile,false);
+	w.setGeometryLock(&geometryLock);
+	w.setGeometryCache(geometry);
+	w.evaluate();
+	int ticks=t.elapsed();
+
+	Registry<Value>::attach(previousValues);
+	Registry<Node>::attach(previousNodes);
+
+	s.flush();
+	runner->report(index,text,w.isExported(),ticks);
+}
+
+BatchRunner::BatchRunner(QTextStream& s) : output(s), geometry(4096)
+{
+	jobs=QThread::idealThreadCount();
+	outputTemplate="%d/%b.stl";
+}
+
+void BatchRunner::setJobs(int j)
+{
+	if(j>0)
+		jobs=j;
+}
+
+void BatchRunner::setOutputTemplate(QString t)
+{
+	if(!t.isEmpty())
+		outputTemplate=t;
+}
+
+/**
+  Arguments starting with @ name a file listing one input per line,
+  arguments containing wildcards are matched against the files in
+  their directory.
+*/
+QStringList BatchRunner::expand(QStringList args)
+{
+	QStringList inputs;
+	foreach(QString a,args) {
+		if(a.startsWith("@")) {
+			QFile f(a.mid(1));
+			if(!f.open(QIODevice::ReadOnly|QIODevice::Text)) {
+				output << "Warning: cannot open list '" << a.mid(1) << "'\n";
+				continue;
+			}
+			QTextStream list(&f);
+			while(!list.atEnd()) {
+				QString line=list.readLine().trimmed();
+				if(!line.isEmpty())
+					inputs.append(line);
+			}
+		} else if(a.contains(QRegExp("[*?\\[]"))) {
+			QFileInfo pattern(a);
+			QDir dir=pattern.dir();
+			QStringList names=dir.entryList(QStringList(pattern.fileName()),QDir::Files,QDir::Name);
+			foreach(QString n,names)
+				inputs.append(dir.filePath(n));
+		} else {
+			inputs.append(a);
+		}
+	}
+	return inputs;
+}
+
+QString BatchRunner::getOutput(QString outputTemplate,QString input)
+{
+	QFileInfo info(input);
+	QString name=outputTemplate;
+	name.replace("%d",info.path());
+	name.replace("%b",info.completeBaseName());
+	return name;
+}
+
+int BatchRunner::run(QStringList args)
+{
+	QStringList inputs=expand(args);
+	if(inputs.isEmpty()) {
+		output << "Warning: no input files.\n";
+		output.flush();
+		return 0;
+	}
+
+	QStringList outputs;
+	foreach(QString in,inputs) {
+		QString out=getOutput(outputTemplate,in);
+		if(outputs.contains(out)) {
+			output << "Warning: output template '" << outputTemplate << "' gives '" << out << "' more than once.\n";
+			output.flush();
+			return inputs.size();
+		}
+		outputs.append(out);
+	}
+
+	//Create the builtins before any of the workers need them.
+	BuiltinCreator::getInstance();
+
+	for(int i=0; i<inputs.size(); i++) {
+		times.append(0);
+		results.append(false);
+	}
+
+	QTime t;
+	t.start();
+	QThreadPool pool;
+	pool.setMaxThreadCount(jobs);
+	for(int i=0; i<inputs.size(); i++)
+		pool.start(new BatchJob(this,&geometry,i,inputs.at(i),outputs.at(i)));
+	pool.waitForDone();
+
+	summary(inputs,t.elapsed());
+
+	return results.count(false);
+}
+
+void BatchRunner::report(int index,QString text,bool built,int ticks)
+{
+	QMutexLocker locker(&reportLock);
+	times[index]=ticks;
+	results[index]=built;
+	output << text;
+	output.flush();
+}
+
+void BatchRunner::summary(QStringList inputs,int ticks)
+{
+	int total=0;
+	int width=0;
+	foreach(QString in,inputs)
+		width=qMax(width,in.length());
+
+	output << "\nTiming summary:\n";
+	for(int i=0; i<inputs.size(); i++) {
+		total+=times.at(i);
+		output << inputs.at(i).leftJustified(width) << QString("%1ms").arg(times.at(i),10);
+		if(!results.at(i))
+			output << "  failed";
+		output << "\n";
+	}
+
+	int failed=results.count(false);
+	output << QString("Rendered %1 of %2 files using %3 workers.\n").arg(inputs.size()-failed).arg(inputs.size()).arg(jobs);
+	output << QString("Total time: %1ms, wall clock: %2ms.\n").arg(total).arg(ticks);
+	output.flush();
+}
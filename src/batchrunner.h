@@ -0,0 +1,59 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMutex>
+#include <QTextStream>
+#include "geometrycache.h"
+
+/**
+  Renders many scripts within one process using a bounded pool of
+  workers. Each script is evaluated with its own values and nodes, while
+  the libraries they include or use are parsed once and shared through
+  the script cache. The output file names are made from a template in
+  which %d is replaced by the directory and %b by the base name of the
+  input.
+*/
+class BatchRunner
+{
+public:
+	BatchRunner(QTextStream&);
+	void setJobs(int);
+	void setOutputTemplate(QString);
+	int run(QStringList);
+	void report(int,QString,bool,int);
+	static QString getOutput(QString,QString);
+private:
+	QStringList expand(QStringList);
+	void summary(QStringList,int);
+
+	QTextStream& output;
+	QString outputTemplate;
+	int jobs;
+	QList<int> times;
+	QList<bool> results;
+	QMutex reportLock;
+	GeometryCache geometry;
+};
+
+#endif // BATCHRUNNER_H
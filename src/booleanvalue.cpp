@@ -22,6 +22,7 @@ BooleanValue::BooleanValue(bool value)
 {
 	this->boolean=value;
 	this->defined=true;
+	this->type=Boolean;
 }
 
 QString BooleanValue::getValueString() const
@@ -29,6 +30,11 @@ QString BooleanValue::getValueString() const
 	return this->boolean ? "true" : "false";
 }
 
+Value* BooleanValue::copy()
+{
+	return new BooleanValue(this->boolean);
+}
+
 bool BooleanValue::isTrue() const
 {
 	return this->boolean;
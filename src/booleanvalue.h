@@ -26,6 +26,7 @@ class BooleanValue : public Value
 public:
 	BooleanValue(bool);
 	QString getValueString() const;
+	Value* copy();
 	bool isTrue() const;
 private:
 	Value* operation(Expression::Operator_e);
@@ -88,7 +88,7 @@
 
 #include "treeprinter.h"
 
-BuiltinCreator::BuiltinCreator(QTextStream& output)
+BuiltinCreator::BuiltinCreator()
 {
 	builtins.append(new CubeModule());
 	builtins.append(new SphereModule());
@@ -124,7 +124,7 @@ BuiltinCreator::BuiltinCreator(QTextStream& output)
 	builtins.append(new ShearModule());
 	builtins.append(new ResizeModule());
 	builtins.append(new CenterModule());
-	builtins.append(new EchoModule(output));
+	builtins.append(new EchoModule());
 	builtins.append(new ChildModule());
 	builtins.append(new BoundsModule());
 
@@ -159,10 +159,10 @@ BuiltinCreator::BuiltinCreator(QTextStream& output)
 
 BuiltinCreator* BuiltinCreator::instance=NULL;
 
-BuiltinCreator* BuiltinCreator::getInstance(QTextStream& output)
+BuiltinCreator* BuiltinCreator::getInstance()
 {
 	if(!instance)
-		instance = new BuiltinCreator(output);
+		instance = new BuiltinCreator();
 
 	return instance;
 }
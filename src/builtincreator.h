@@ -26,12 +26,12 @@
 class BuiltinCreator
 {
 public:
-	static BuiltinCreator* getInstance(QTextStream& output);
+	static BuiltinCreator* getInstance();
 	void initBuiltins(Script*);
 	void saveBuiltins(Script*);
 	void generateDocs(QTextStream&);
 private:
-	BuiltinCreator(QTextStream& output);
+	BuiltinCreator();
 	static BuiltinCreator* instance;
 	QList<Declaration*> builtins;
 };
@@ -23,11 +23,27 @@
 #include <QTextStream>
 #include <QString>
 #include <QXmlStreamWriter>
+#include <QHash>
 #include <CGAL/IO/Polyhedron_iostream.h>
 
 CGALExport::CGALExport(CGALPrimitive* p)
 {
 	primitive=p;
+	polyhedron=NULL;
+}
+
+CGALExport::~CGALExport()
+{
+	delete polyhedron;
+}
+
+/* Converting the result is costly, so it is only done once however
+ * many times it is exported. */
+CGAL::Polyhedron3* CGALExport::getPolyhedron()
+{
+	if(!polyhedron)
+		polyhedron=primitive->getPolyhedron();
+	return polyhedron;
 }
 
 void CGALExport::exportResult(QString filename)
@@ -46,7 +62,7 @@ void CGALExport::exportResult(QString filename)
 void CGALExport::exportOFF(QString filename)
 {
 	//http://people.sc.fsu.edu/~jburkardt/data/off/off.html
-	CGAL::Polyhedron3* poly=primitive->getPolyhedron();
+	CGAL::Polyhedron3* poly=getPolyhedron();
 	std::ofstream file(filename.toLocal8Bit().constData());
 	file << *poly;
 	file.close();
@@ -59,7 +75,7 @@ typedef CGAL::Polyhedron3::Halfedge_around_facet_const_circulator HalffacetCircu
 
 void CGALExport::exportAsciiSTL(QString filename, bool precise)
 {
-	CGAL::Polyhedron3* poly=primitive->getPolyhedron();
+	CGAL::Polyhedron3* poly=getPolyhedron();
 
 	QFile data(filename);
 	if(!data.open(QFile::WriteOnly | QFile::Truncate)) {
@@ -134,7 +150,7 @@ void CGALExport::exportAsciiSTL(QString filename, bool precise)
 void CGALExport::exportAMF(QString filename)
 {
 	//currently does not support multi material - sk12/04/07
-	CGAL::Polyhedron3* poly=primitive->getPolyhedron();
+	CGAL::Polyhedron3* poly=getPolyhedron();
 
 	QFile* file=new QFile(filename);
 	if(!file->open(QIODevice::WriteOnly)) {
@@ -222,4 +238,38 @@ void CGALExport::exportAMF(QString filename)
 	delete file;
 
 }
+/**
+  Gives the vertices of the result as x, y and z coordinates and its
+  facets as triangles of three indices into the vertices.
+*/
+void CGALExport::exportMesh(QVector<double>& vertices,QVector<int>& triangles)
+{
+	CGAL::Polyhedron3* poly=getPolyhedron();
+
+	QHash<const Vertex*,int> indices;
+	for(VertexIterator vi = poly->vertices_begin(); vi != poly->vertices_end(); ++vi) {
+		indices.insert(&*vi,indices.size());
+		CGAL::Point3 p=vi->point();
+		vertices.append(to_double(p.x()));
+		vertices.append(to_double(p.y()));
+		vertices.append(to_double(p.z()));
+	}
+
+	for(FacetIterator fi = poly->facets_begin(); fi != poly->facets_end(); ++fi) {
+		HalffacetCirculator hc = fi->facet_begin();
+		HalffacetCirculator he = hc;
+		const Vertex *v1, *v2, *v3;
+		v1 = &*(hc++)->vertex();
+		v3 = &*(hc++)->vertex();
+		do {
+			v2 = v3;
+			v3 = &*(hc++)->vertex();
+			if(v1->point() == v2->point() || v1->point() == v3->point() || v2->point() == v3->point())
+				continue;
+			triangles.append(indices.value(v1));
+			triangles.append(indices.value(v2));
+			triangles.append(indices.value(v3));
+		} while(hc != he);
+	}
+}
 #endif
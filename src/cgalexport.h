@@ -20,18 +20,23 @@
 #define CGALEXPORT_H
 
 #include <QString>
+#include <QVector>
 #include "cgalprimitive.h"
 
 class CGALExport
 {
 public:
 	CGALExport(CGALPrimitive*);
+	~CGALExport();
 	void exportResult(QString);
+	void exportMesh(QVector<double>&,QVector<int>&);
 private:
+	CGAL::Polyhedron3* getPolyhedron();
 	void exportOFF(QString);
 	void exportAsciiSTL(QString,bool);
 	void exportAMF(QString);
 	CGALPrimitive* primitive;
+	CGAL::Polyhedron3* polyhedron;
 };
 
 #endif // CGALEXPORT_H
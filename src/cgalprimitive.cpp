@@ -1,6 +1,7 @@
 #if USE_CGAL
 #include "cgalprimitive.h"
 #include <QPair>
+#include <sstream>
 #include <CGAL/minkowski_sum_3.h>
 #include "cgalbuilder.h"
 
@@ -147,4 +148,25 @@ bool CGALPrimitive::isFullyDimentional()
 	//volume and the inner volume. So check volumes > 1
 	return nefPolyhedron->number_of_volumes()>1;
 }
+
+Primitive* CGALPrimitive::copy()
+{
+	//NefPolyhedron3 shares its representation until it is modified
+	CGALPrimitive* p=new CGALPrimitive();
+	p->nefPolyhedron=new CGAL::NefPolyhedron3(*nefPolyhedron);
+	return p;
+}
+
+/* A copy that shares nothing with this one, not even the numbers of its
+ * points, so that it can be handed to another thread. The reference
+ * counts of what copy() shares are not safe to change from two threads. */
+CGALPrimitive* CGALPrimitive::deepCopy() const
+{
+	std::stringstream data;
+	data << *nefPolyhedron;
+	CGALPrimitive* p=new CGALPrimitive();
+	p->nefPolyhedron=new CGAL::NefPolyhedron3();
+	data >> *p->nefPolyhedron;
+	return p;
+}
 #endif
@@ -47,6 +47,8 @@ public:
 	const CGAL::NefPolyhedron3& getNefPolyhedron() const;
 	CGAL::Polyhedron3* getPolyhedron();
 	bool isFullyDimentional();
+	Primitive* copy();
+	CGALPrimitive* deepCopy() const;
 private:
 	QList<CGALPolygon*> polygons;
 	QList<CGAL::Point3> points;
@@ -15,68 +15,127 @@
  *   You should have received a copy of the GNU General Public License
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+
 #if USE_CGAL
+#include <QHash>
+#include <QList>
 #include "cgalrenderer.h"
-#include "preferences.h"
-
-using CGAL::OGL::Nef3_Converter;
+#include "contrib/OGL_helper.h"
 
-CGALRenderer::CGALRenderer(CGALPrimitive* pr)
-{
-	Preferences* p = Preferences::getInstance();
-	setColor(markedVertexColor,p->getMarkedVertexColor());
-	setColor(vertexColor,p->getVertexColor());
-	setColor(markedEdgeColor,p->getMarkedEdgeColor());
-	setColor(edgeColor,p->getEdgeColor());
-	setColor(markedFacetColor,p->getMarkedFacetColor());
-	setColor(facetColor,p->getFacetColor());
-	vertexSize=p->getVertexSize();
-	edgeSize=p->getEdgeSize();
-	Nef3_Converter<CGAL::NefPolyhedron3>::convert_to_OGLPolyhedron(pr->getNefPolyhedron(),this);
-}
+typedef CGAL::NefPolyhedron3::Vertex_const_iterator VertexIterator;
+typedef CGAL::NefPolyhedron3::Halfedge_const_iterator HalfedgeIterator;
+typedef CGAL::NefPolyhedron3::Halffacet_const_iterator HalffacetIterator;
+typedef CGAL::NefPolyhedron3::Halffacet_const_handle HalffacetHandle;
+typedef CGAL::NefPolyhedron3::Halffacet_cycle_const_iterator HalffacetCycleIterator;
+typedef CGAL::NefPolyhedron3::SHalfedge_const_handle SHalfedgeHandle;
+typedef CGAL::NefPolyhedron3::SHalfedge_around_facet_const_circulator SHalfedgeCirculator;
 
-void CGALRenderer::draw(bool skeleton, bool showedges)
+/* The state of the tessellation of one facet. Each vertex handed to
+ * the tessellator carries its index in the mesh as a fourth component. */
+class Tessellation
 {
-	init();
-	if(!skeleton) {
-		glCallList(this->object_list_+2);
+public:
+	Tessellation(MeshRenderer* r,bool m,double x,double y,double z) :
+		renderer(r), mark(m), nx(x), ny(y), nz(z) {}
+	~Tessellation()
+	{
+		foreach(GLdouble* v,vertices)
+			delete[] v;
 	}
-	if(skeleton||showedges) {
-		glDisable(GL_LIGHTING);
-		glCallList(this->object_list_+1);
-		glCallList(this->object_list_);
-		glEnable(GL_LIGHTING);
+	GLdouble* vertex(double x,double y,double z)
+	{
+		GLdouble* v=new GLdouble[4];
+		v[0]=x;
+		v[1]=y;
+		v[2]=z;
+		v[3]=renderer->appendVertex(x,y,z,nx,ny,nz);
+		vertices.append(v);
+		return v;
 	}
-}
+	MeshRenderer* renderer;
+	bool mark;
+	double nx,ny,nz;
+	QList<int> corners;
+	QList<GLdouble*> vertices;
+};
 
-void CGALRenderer::setColor(CGAL::Color& t,QColor c)
+static void CGAL_GLU_TESS_CALLBACK vertexCallback(GLvoid* vertex,GLvoid* data)
 {
-	CGAL::Color cc(c.red(),c.green(),c.blue(),c.alpha());
-	t=cc;
+	GLdouble* v=static_cast<GLdouble*>(vertex);
+	Tessellation* t=static_cast<Tessellation*>(data);
+	t->corners.append((int)v[3]);
+	if(t->corners.size()==3) {
+		t->renderer->appendTriangle(t->corners.at(0),t->corners.at(1),t->corners.at(2),t->mark);
+		t->corners.clear();
+	}
 }
 
-CGAL::Color CGALRenderer::getVertexColor(bool mark) const
+static void CGAL_GLU_TESS_CALLBACK combineCallback(GLdouble coords[3],GLvoid*[4],GLfloat[4],GLvoid** out,GLvoid* data)
 {
-	return mark ? markedVertexColor : vertexColor;
+	Tessellation* t=static_cast<Tessellation*>(data);
+	*out=t->vertex(coords[0],coords[1],coords[2]);
 }
 
-CGAL::Color CGALRenderer::getEdgeColor(bool mark) const
+//Having an edge flag callback makes the tessellator produce only triangles
+static void CGAL_GLU_TESS_CALLBACK edgeFlagCallback(GLboolean)
 {
-	return mark ? markedEdgeColor : edgeColor;
 }
 
-CGAL::Color CGALRenderer::getFacetColor(bool mark) const
+CGALRenderer::CGALRenderer(CGALPrimitive* pr)
 {
-	return mark ? markedFacetColor : facetColor;
-}
+	const CGAL::NefPolyhedron3& poly=pr->getNefPolyhedron();
+	QHash<const void*,int> indices;
+	VertexIterator v;
+	CGAL_forall_vertices(v,*poly.sncp()) {
+		CGAL::Point3 pt=v->point();
+		int i=appendVertex(to_double(pt.x()),to_double(pt.y()),to_double(pt.z()));
+		indices.insert(&*v,i);
+		appendPoint(i,v->mark());
+	}
 
-double CGALRenderer::getVertexSize() const
-{
-	return vertexSize;
+	HalfedgeIterator e;
+	CGAL_forall_edges(e,*poly.sncp())
+		appendEdge(indices.value(&*e->source()),indices.value(&*e->twin()->source()),e->mark());
+
+	HalffacetIterator f;
+	CGAL_forall_facets(f,*poly.sncp())
+		tessellate(f);
 }
 
-double CGALRenderer::getEdgeSize() const
+/* Facets can be concave and can have holes so they are tessellated,
+ * each facet gets its own copy of its vertices to carry its normal. */
+void CGALRenderer::tessellate(const HalffacetHandle& f)
 {
-	return edgeSize;
+	CGAL::Vector3 n=f->plane().orthogonal_vector();
+	double nx=to_double(n.x()),ny=to_double(n.y()),nz=to_double(n.z());
+	Tessellation t(this,f->mark(),nx,ny,nz);
+
+	GLUtesselator* tess=gluNewTess();
+	gluTessCallback(tess,GLenum(GLU_TESS_VERTEX_DATA),
+		(GLvoid (CGAL_GLU_TESS_CALLBACK*)(CGAL_GLU_TESS_DOTS))&vertexCallback);
+	gluTessCallback(tess,GLenum(GLU_TESS_COMBINE_DATA),
+		(GLvoid (CGAL_GLU_TESS_CALLBACK*)(CGAL_GLU_TESS_DOTS))&combineCallback);
+	gluTessCallback(tess,GLenum(GLU_TESS_EDGE_FLAG),
+		(GLvoid (CGAL_GLU_TESS_CALLBACK*)(CGAL_GLU_TESS_DOTS))&edgeFlagCallback);
+	gluTessProperty(tess,GLenum(GLU_TESS_WINDING_RULE),GLU_TESS_WINDING_POSITIVE);
+
+	gluTessBeginPolygon(tess,&t);
+	gluTessNormal(tess,nx,ny,nz);
+	HalffacetCycleIterator fc;
+	CGAL_forall_facet_cycles_of(fc,f) {
+		if(!fc.is_shalfedge())
+			continue;
+		gluTessBeginContour(tess);
+		SHalfedgeHandle h=fc;
+		SHalfedgeCirculator hc(h),he(hc);
+		CGAL_For_all(hc,he) {
+			CGAL::Point3 pt=hc->source()->source()->point();
+			GLdouble* v=t.vertex(to_double(pt.x()),to_double(pt.y()),to_double(pt.z()));
+			gluTessVertex(tess,v,v);
+		}
+		gluTessEndContour(tess);
+	}
+	gluTessEndPolygon(tess);
+	gluDeleteTess(tess);
 }
 #endif
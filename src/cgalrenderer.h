@@ -15,35 +15,21 @@
  *   You should have received a copy of the GNU General Public License
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+
 #if USE_CGAL
 #ifndef CGALRENDERER_H
 #define CGALRENDERER_H
 
 #include <QColor>
-#include "contrib/OGL_helper.h"
-#include "renderer.h"
+#include "meshrenderer.h"
 #include "cgalprimitive.h"
 
-class CGALRenderer : public Renderer, private CGAL::OGL::Polyhedron
+class CGALRenderer : public MeshRenderer
 {
 public:
 	CGALRenderer(CGALPrimitive*);
-	void draw(bool,bool);
 private:
-	void setColor(CGAL::Color&,QColor);
-	CGAL::Color getVertexColor(bool mark) const;
-	CGAL::Color getEdgeColor(bool mark) const;
-	CGAL::Color getFacetColor(bool mark) const;
-	double getVertexSize() const;
-	double getEdgeSize() const;
-	CGAL::Color markedVertexColor;
-	CGAL::Color vertexColor;
-	CGAL::Color markedEdgeColor;
-	CGAL::Color edgeColor;
-	CGAL::Color markedFacetColor;
-	CGAL::Color facetColor;
-	double vertexSize;
-	double edgeSize;
+	void tessellate(const CGAL::NefPolyhedron3::Halffacet_const_handle&);
 };
 
 #endif // CGALRENDERER_H
@@ -58,11 +58,6 @@ int CodeEditor::lineNumberAreaWidth()
 	return space;
 }
 
-void CodeEditor::stopHighlighting()
-{
-	highlighter->stop();
-}
-
 void CodeEditor::setFileName(const QString& f)
 {
 	fileName=f;
@@ -19,12 +19,14 @@
 #include "context.h"
 #include "modulescope.h"
 
-Context::Context(QTextStream& s) : output(s)
+Context::Context(QTextStream& s) : output(s), random(0)
 {
 	parent=NULL;
 	currentValue=NULL;
 	returnValue=NULL;
 	currentScope=NULL;
+	currentSymbol=0;
+	diagnostics=NULL;
 }
 
 void Context::setParent(Context* value)
@@ -62,56 +64,95 @@ void Context::setCurrentValue(Value* value)
 	currentValue=value;
 }
 
-QString Context::getCurrentName()
+int Context::getCurrentSymbol()
 {
-	return currentName;
+	return currentSymbol;
 }
 
-void Context::setCurrentName(QString value)
+void Context::setCurrentSymbol(int value)
 {
-	currentName=value;
+	currentSymbol=value;
 }
 
-Module* Context::lookupModule(QString name)
+/* Modules and functions are cached in the context that declares
+ * them. Contexts can be shared by the workers evaluating a parallel
+ * for loop, so each context guards its caches with its own lock which
+ * lookups only take for reading. The declarations of a scope don't
+ * change during evaluation and are searched without it. */
+Module* Context::lookupModule(int name)
 {
-	if(!modules.contains(name)) {
-		foreach(Declaration* d,currentScope->getDeclarations()) {
-			Module* mod = dynamic_cast<Module*>(d);
-			if(mod && mod->getName() == name) {
-				modules.insert(name,mod);
-				return mod;
-			}
+	declarationsLock.lockForRead();
+	Module* cached=modules.value(name);
+	declarationsLock.unlock();
+	if(cached)
+		return cached;
+
+	foreach(Declaration* d,currentScope->getDeclarations()) {
+		Module* mod = dynamic_cast<Module*>(d);
+		if(mod && mod->getSymbol() == name) {
+			addModule(mod);
+			return mod;
+		}
+	}
+
+	//Libraries may need loading, which is done outside of the lock
+	declarationsLock.lockForRead();
+	QList<ScriptLibrary*> libs=libraries;
+	declarationsLock.unlock();
+	foreach(ScriptLibrary* lib,libs) {
+		Module* mod = lib->lookupModule(name);
+		if(mod) {
+			addModule(mod);
+			return mod;
 		}
-		if(parent)
-			return parent->lookupModule(name);
 	}
 
-	return modules.value(name);
+	if(parent)
+		return parent->lookupModule(name);
+
+	return NULL;
 }
 
-Function* Context::lookupFunction(QString name)
+Function* Context::lookupFunction(int name)
 {
-	if(!functions.contains(name)) {
-		//We are not looking for the function within the function
-		//scope (which is invalid syntax) but rather in the current
-		//scope which could be a module or script
-		foreach(Declaration* d,currentScope->getDeclarations()) {
-			Function* func = dynamic_cast<Function*>(d);
-			if(func && func->getName() == name) {
-				functions.insert(name,func);
-				return func;
-			}
+	declarationsLock.lockForRead();
+	Function* cached=functions.value(name);
+	declarationsLock.unlock();
+	if(cached)
+		return cached;
+
+	//We are not looking for the function within the function
+	//scope (which is invalid syntax) but rather in the current
+	//scope which could be a module or script
+	foreach(Declaration* d,currentScope->getDeclarations()) {
+		Function* func = dynamic_cast<Function*>(d);
+		if(func && func->getSymbol() == name) {
+			addFunction(func);
+			return func;
 		}
-		if(parent)
-			return parent->lookupFunction(name);
 	}
 
-	return functions.value(name);
+	//Libraries may need loading, which is done outside of the lock
+	declarationsLock.lockForRead();
+	QList<ScriptLibrary*> libs=libraries;
+	declarationsLock.unlock();
+	foreach(ScriptLibrary* lib,libs) {
+		Function* func = lib->lookupFunction(name);
+		if(func) {
+			addFunction(func);
+			return func;
+		}
+	}
+
+	if(parent)
+		return parent->lookupFunction(name);
+
+	return NULL;
 }
 
 bool Context::addVariable(Value* v)
 {
-	QString name=v->getName();
+	int name=v->getSymbol();
 	if(!variables.contains(name)) {
 		variables.insert(name,v);
 		return true;
@@ -121,10 +162,10 @@ bool Context::addVariable(Value* v)
 
 void Context::setVariable(Value* v)
 {
-	variables.insert(v->getName(),v);
+	variables.insert(v->getSymbol(),v);
 }
 
-Value* Context::lookupVariable(QString name,Variable::StorageClass_e& c)
+Value* Context::lookupVariable(int name,Variable::StorageClass_e& c)
 {
 	if(variables.contains(name)) {
 		Value* v=variables.value(name);
@@ -141,23 +182,33 @@ Value* Context::lookupVariable(QString name,Variable::StorageClass_e& c)
 
 void Context::addModule(Module* mod)
 {
-	modules.insert(mod->getName(),mod);
+	QWriteLocker locker(&declarationsLock);
+	modules.insert(mod->getSymbol(),mod);
 }
 
 void Context::addFunction(Function* func)
 {
-	functions.insert(func->getName(),func);
+	QWriteLocker locker(&declarationsLock);
+	functions.insert(func->getSymbol(),func);
+}
+
+/* Libraries are searched after the declarations of the current scope
+ * and are only loaded once a name is not found there. */
+void Context::addLibrary(ScriptLibrary* lib)
+{
+	QWriteLocker locker(&declarationsLock);
+	libraries.append(lib);
 }
 
 void Context::setArguments(QList<Value*> args, QList<Value*> params)
 {
 	for(int i=0; i<params.size(); i++) {
 		Value* val=params.at(i);
-		QString paramName=val->getName();
+		int paramName=val->getSymbol();
 		for(int j=0; j<args.size(); j++) {
 			Value* arg=args.at(j);
-			QString argName=arg->getName();
-			if((i==j && argName.isEmpty()) || argName==paramName) {
+			int argName=arg->getSymbol();
+			if((i==j && !argName) || argName==paramName) {
 				if(arg->isDefined()) {
 					val=arg;
 					break;
@@ -183,21 +234,22 @@ void Context::clearArguments()
 	arguments.clear();
 }
 
-Value* Context::getArgument(int index, QString name)
+/**
+  Parameters are matched by their symbols, or by their abbreviation, so
+  the names are only interned when the parameters are created.
+*/
+Value* Context::getArgument(int index, Parameter* p)
 {
-	//TODO make matchLast work for name ending with any digit
-	bool matchLast = name.endsWith('1') || name.endsWith('2');
-
-	return matchArgumentIndex(true,matchLast,index,name);
+	return matchArgumentIndex(index,p->getSymbol(),p->getAbbreviation());
 }
 
-Value* Context::getArgumentDeprecated(int index, QString name, QString deprecated)
+Value* Context::getArgumentDeprecated(int index, Parameter* p, Parameter* deprecated)
 {
-	Value* v = matchArgumentIndex(true,false,index,name);
+	Value* v = matchArgumentIndex(index,p->getSymbol(),p->getAbbreviation());
 	if(!v) {
-		v = matchArgumentIndex(false,false,index,deprecated);
+		v = matchArgumentIndex(index,deprecated->getSymbol(),0);
 		if(v)
-			output << "Warning '" << deprecated << "' parameter is deprecated use '" << name << "' instead\n";
+			output << "Warning '" << deprecated->getName() << "' parameter is deprecated use '" << p->getName() << "' instead\n";
 	}
 
 	return v;
@@ -243,46 +295,76 @@ void Context::addCurrentNode(Node* value)
 	currentNodes.append(value);
 }
 
-Value* Context::getArgumentSpecial(QString name)
+QTextStream& Context::getOutput()
 {
-	Value* v=matchArgument(false,false,name);
+	return output;
+}
+
+/**
+  Where output is recorded when it has to stay in order with the
+  warnings, rather than written straight out.
+*/
+void Context::setDiagnostics(DiagnosticSink* d)
+{
+	diagnostics=d;
+}
+
+DiagnosticSink* Context::getDiagnostics()
+{
+	return diagnostics;
+}
+
+Value* Context::getArgumentSpecial(int name)
+{
+	Value* v=matchArgument(name,0);
 	if(v && v->getStorageClass()==Variable::Special)
 		return v;
 
 	return NULL;
 }
 
-Value* Context::matchArgumentIndex(bool allowChar,bool matchLast, int index, QString name)
+Value* Context::matchArgumentIndex(int index, int name, int abbreviation)
 {
 	if(index >= arguments.size())
 		return NULL;
 
 	Value* arg = arguments.at(index);
-	QString argName = arg->getName();
-	if(argName.isEmpty() || match(allowChar,matchLast,argName,name))
+	int argName = arg->getSymbol();
+	if(!argName || match(argName,name,abbreviation))
 		return arg;
 
-	return matchArgument(allowChar,matchLast,name);
+	return matchArgument(name,abbreviation);
 }
 
-Value* Context::matchArgument(bool allowChar,bool matchLast, QString name)
+Value* Context::matchArgument(int name, int abbreviation)
 {
 	foreach(Value* namedArg,arguments) {
-		QString namedArgName = namedArg->getName();
-		if(match(allowChar,matchLast,namedArgName,name))
+		int namedArgName = namedArg->getSymbol();
+		if(match(namedArgName,name,abbreviation))
 			return namedArg;
 	}
 
 	return NULL;
 }
 
-bool Context::match(bool allowChar,bool matchLast, QString a,QString n)
+bool Context::match(int symbolA, int symbolN, int abbreviation)
 {
-	if(allowChar) {
-		if(matchLast&&a.length()==2)
-			return a.left(1)==n.left(1) && a.right(1)==n.right(1);
-		if(!matchLast&&a.length()==1)
-			return a.left(1)==n.left(1);
-	}
-	return a==n;
+	return symbolA==symbolN || (abbreviation && symbolA==abbreviation);
+}
+
+/**
+  Each context draws its random numbers and the seeds of the contexts
+  it starts from its own seed, so that they follow from the evaluation
+  seed and from where in the script they are drawn, never from the order
+  in which threads get to them. Only the evaluator that owns the context
+  draws from it.
+*/
+void Context::setSeed(quint64 s)
+{
+	random=Random(s);
+}
+
+quint64 Context::nextSeed()
+{
+	return random.split();
 }
@@ -20,11 +20,15 @@
 #define CONTEXT_H
 
 #include <QHash>
+#include <QReadWriteLock>
 #include <QTextStream>
 #include "value.h"
 #include "module.h"
 #include "function.h"
 #include "scope.h"
+#include "scriptlibrary.h"
+#include "diagnosticsink.h"
+#include "random.h"
 
 class Context
 {
@@ -42,27 +46,29 @@ public:
 	Value* getCurrentValue();
 	void setCurrentValue(Value*);
 
-	QString getCurrentName();
-	void setCurrentName(QString);
+	int getCurrentSymbol();
+	void setCurrentSymbol(int);
 
-	Value* lookupVariable(QString,Variable::StorageClass_e&);
+	Value* lookupVariable(int,Variable::StorageClass_e&);
 	bool addVariable(Value*);
 	void setVariable(Value*);
 
-	Module* lookupModule(QString);
+	Module* lookupModule(int);
 	void addModule(Module* mod);
 
-	Function* lookupFunction(QString);
+	Function* lookupFunction(int);
 	void addFunction(Function*);
 
+	void addLibrary(ScriptLibrary*);
+
 	void setArguments(QList<Value*>,QList<Value*>);
 	QList<Value*> getArguments();
 	void addArgument(Value*);
 	void clearArguments();
 
-	Value* getArgument(int,QString);
-	Value* getArgumentSpecial(QString);
-	Value* getArgumentDeprecated(int,QString,QString);
+	Value* getArgument(int,Parameter*);
+	Value* getArgumentSpecial(int);
+	Value* getArgumentDeprecated(int,Parameter*,Parameter*);
 
 	QList<Value*> getParameters();
 	void clearParameters();
@@ -74,6 +80,12 @@ public:
 	void setCurrentNodes(QList<Node*>);
 	QList<Node*> getCurrentNodes();
 	void addCurrentNode(Node*);
+
+	QTextStream& getOutput();
+	void setDiagnostics(DiagnosticSink*);
+	DiagnosticSink* getDiagnostics();
+	void setSeed(quint64);
+	quint64 nextSeed();
 private:
 	Context* parent;
 	QList<Value*> arguments;
@@ -82,15 +94,19 @@ private:
 	QList<Node*> inputNodes;
 	Value* currentValue;
 	Value* returnValue;
-	QString currentName;
+	int currentSymbol;
 	Scope* currentScope;
-	Value* matchArgumentIndex(bool,bool,int,QString);
-	Value* matchArgument(bool,bool,QString);
-	bool match(bool,bool,QString,QString);
-	QHash<QString,Value*> variables;
-	QHash<QString,Module*> modules;
-	QHash<QString,Function*> functions;
+	Value* matchArgumentIndex(int,int,int);
+	Value* matchArgument(int,int);
+	bool match(int,int,int);
+	QHash<int,Value*> variables;
+	QHash<int,Module*> modules;
+	QHash<int,Function*> functions;
+	QList<ScriptLibrary*> libraries;
+	QReadWriteLock declarationsLock;
 	QTextStream& output;
+	DiagnosticSink* diagnostics;
+	Random random;
 };
 
 #endif // CONTEXT_H
@@ -20,8 +20,29 @@
 
 Declaration::Declaration()
 {
+	lineNumber=0;
 }
 
 Declaration::~Declaration()
 {
 }
+
+/**
+  Where the declaration was parsed from, so that warnings can point
+  at it. The file is empty for text that was not read from a file.
+*/
+void Declaration::setLocation(QString f,int l)
+{
+	sourceFile=f;
+	lineNumber=l;
+}
+
+QString Declaration::getSourceFile() const
+{
+	return sourceFile;
+}
+
+int Declaration::getLineNumber() const
+{
+	return lineNumber;
+}
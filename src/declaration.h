@@ -27,6 +27,12 @@ class Declaration : public VisitableTree
 public:
 	Declaration();
 	virtual ~Declaration();
+	void setLocation(QString,int);
+	QString getSourceFile() const;
+	int getLineNumber() const;
+private:
+	QString sourceFile;
+	int lineNumber;
 };
 
 #endif // DECLARATION_H
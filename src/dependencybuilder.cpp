@@ -17,6 +17,7 @@
  */
 
 #include "dependencybuilder.h"
+#include "scriptcache.h"
 
 DependencyBuilder::DependencyBuilder()
 {
@@ -26,6 +27,10 @@ DependencyBuilder::~DependencyBuilder()
 {
 }
 
+void DependencyBuilder::setTokenizer(AbstractTokenBuilder*)
+{
+}
+
 void DependencyBuilder::buildScript(Declaration*)
 {
 }
@@ -58,23 +63,34 @@ QList<CodeDoc*>* DependencyBuilder::buildCodeDoc(QString*,QString*,QList<CodeDoc
 	return NULL;
 }
 
-Declaration* DependencyBuilder::buildUse(QString*)
+Declaration* DependencyBuilder::buildUse(QString* imp)
 {
+	dependencies.append(*imp);
+	delete imp;
 	return NULL;
 }
 
-Declaration* DependencyBuilder::buildUse(QString*,QString*)
+Declaration* DependencyBuilder::buildUse(QString* imp,QString* name)
 {
+	dependencies.append(*imp);
+	delete imp;
+	delete name;
 	return NULL;
 }
 
-Declaration* DependencyBuilder::buildImport(QString*,QString*)
+Declaration* DependencyBuilder::buildImport(QString* imp,QString* name)
 {
+	dependencies.append(*imp);
+	delete imp;
+	delete name;
 	return NULL;
 }
 
-Declaration* DependencyBuilder::buildImport(QString*,QString*,QList<Parameter*>*)
+Declaration* DependencyBuilder::buildImport(QString* imp,QString* name,QList<Parameter*>*)
 {
+	dependencies.append(*imp);
+	delete imp;
+	delete name;
 	return NULL;
 }
 
@@ -103,6 +119,29 @@ QList<Declaration*>* DependencyBuilder::buildDeclarations(Declaration*)
 	return NULL;
 }
 
+QList<Declaration*>* DependencyBuilder::buildInclude(Script* inc)
+{
+	dependencies.append(inc->getFileName());
+	ScriptCache::getInstance()->release(inc);
+	return NULL;
+}
+
+QList<Declaration*>* DependencyBuilder::buildInclude(QList<Declaration*>*,Script* inc)
+{
+	return buildInclude(inc);
+}
+
+/**
+  Every file the tokenizer included, including those nested inside
+  braces that were pasted in as text and never reach buildInclude.
+*/
+void DependencyBuilder::buildIncludes(QList<QString> includes)
+{
+	foreach(QString inc,includes)
+		if(!dependencies.contains(inc))
+			dependencies.append(inc);
+}
+
 Statement* DependencyBuilder::buildStatement(Statement*)
 {
 	return NULL;
@@ -392,3 +431,8 @@ Script* DependencyBuilder::getResult() const
 {
 	return NULL;
 }
+
+QList<QString> DependencyBuilder::getDependencies() const
+{
+	return dependencies;
+}
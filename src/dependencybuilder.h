@@ -26,6 +26,7 @@ class DependencyBuilder : public AbstractSyntaxTreeBuilder
 public:
 	DependencyBuilder();
 	~DependencyBuilder();
+	void setTokenizer(AbstractTokenBuilder*);
 	void buildScript(Declaration*);
 	void buildScript(QList<Declaration*>*);
 	void buildScript(QList<CodeDoc*>*);
@@ -42,6 +43,9 @@ public:
 	QList<Declaration*>* buildDeclarations(Declaration*);
 	QList<Declaration*>* buildDeclarations(QList<Declaration*>*);
 	QList<Declaration*>* buildDeclarations(QList<Declaration*>*,Declaration*);
+	QList<Declaration*>* buildInclude(Script*);
+	QList<Declaration*>* buildInclude(QList<Declaration*>*,Script*);
+	void buildIncludes(QList<QString>);
 	Statement* buildStatement(Statement*);
 	Statement* buildStatement(Variable*,Expression::Operator_e);
 	Statement* buildStatement(Variable*,Expression::Operator_e,Expression*);
@@ -101,6 +105,9 @@ public:
 	Invocation* buildInvocation(QString*,Invocation*);
 
 	Script* getResult() const;
+	QList<QString> getDependencies() const;
+private:
+	QList<QString> dependencies;
 };
 
 #endif // DEPENDENCYBUILDER_H
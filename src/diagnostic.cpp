@@ -0,0 +1,201 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "diagnostic.h"
+
+Diagnostic::Diagnostic(Code_e c,QStringList args)
+{
+	code=c;
+	line=0;
+	arguments=args;
+	next=NULL;
+}
+
+void Diagnostic::setLocation(QString f,int l)
+{
+	file=f;
+	line=l;
+}
+
+Diagnostic::Code_e Diagnostic::getCode() const
+{
+	return code;
+}
+
+Diagnostic::Severity_e Diagnostic::getSeverity() const
+{
+	switch(code) {
+	case SyntaxError:
+	case IllegalToken:
+	case FileMissing:
+		return Error;
+	case Echo:
+		return Message;
+	default:
+		return Warning;
+	}
+}
+
+QString Diagnostic::getFile() const
+{
+	return file;
+}
+
+int Diagnostic::getLine() const
+{
+	return line;
+}
+
+QStringList Diagnostic::getArguments() const
+{
+	return arguments;
+}
+
+/**
+  The name by which tools can identify the diagnostic.
+*/
+QString Diagnostic::getName() const
+{
+	switch(code) {
+	case SyntaxError:
+		return "syntax-error";
+	case IllegalToken:
+		return "illegal-token";
+	case FileMissing:
+		return "file-missing";
+	case ModuleMissing:
+		return "module-missing";
+	case FunctionMissing:
+		return "function-missing";
+	case ModuleReturn:
+		return "module-return";
+	case GlobalReturn:
+		return "global-return";
+	case ConstantAltered:
+		return "constant-altered";
+	case ParametricAltered:
+		return "parametric-altered";
+	case ConstantRedeclared:
+		return "constant-redeclared";
+	case ParametricRedeclared:
+		return "parametric-redeclared";
+	case AdditionalCommas:
+		return "additional-commas";
+	case BuildPlatform:
+		return "build-platform";
+	case RangeLimited:
+		return "range-limited";
+	case RangeUndefined:
+		return "range-undefined";
+	case Echo:
+		return "echo";
+	}
+	return QString();
+}
+
+QString Diagnostic::getMessage() const
+{
+	QStringList a=arguments;
+	while(a.size()<3)
+		a.append(QString());
+
+	switch(code) {
+	case SyntaxError:
+		return QString("line %1: %2 at character %3: '%4'.").arg(QString::number(line),a.at(0),a.at(1),a.at(2));
+	case IllegalToken:
+		return QString("%1: illegal token '%2'.").arg(QString::number(line),a.at(0));
+	case FileMissing:
+		return QString("Can't open input file '%1'").arg(a.at(0));
+	case ModuleMissing:
+		return QString("Warning: cannot find module '%1'.").arg(a.at(0));
+	case FunctionMissing:
+		return QString("Warning: cannot find function '%1'.").arg(a.at(0));
+	case ModuleReturn:
+		return "Warning: return statement not valid inside module scope.";
+	case GlobalReturn:
+		return "Warning: return statement not valid inside global scope.";
+	case ConstantAltered:
+		return QString("Warning: Attempt to alter constant variable '%1'").arg(a.at(0));
+	case ParametricAltered:
+		return QString("Warning: Attempt to alter parametric variable '%1'").arg(a.at(0));
+	case ConstantRedeclared:
+		return QString("Warning: Attempt to make previously non-constant variable '%1' constant").arg(a.at(0));
+	case ParametricRedeclared:
+		return QString("Warning: Attempt to make previously non-parametric variable '%1' parametric").arg(a.at(0));
+	case AdditionalCommas:
+		return QString("Warning: %1 additional comma(s) found at the end of vector expression.").arg(a.at(0));
+	case BuildPlatform:
+		return QString("Warning: The model is %1 %2 the build platform.").arg(a.at(0),a.at(1));
+	case RangeLimited:
+		return QString("Warning: the range %1 has too many values, only the first %2 are used.").arg(a.at(0),a.at(1));
+	case RangeUndefined:
+		return QString("Warning: the range %1 does not have a finite number of values.").arg(a.at(0));
+	case Echo:
+		return a.at(0);
+	}
+	return QString();
+}
+
+static QString escape(QString s)
+{
+	QString result;
+	foreach(QChar c,s) {
+		if(c=='\\' || c=='"')
+			result.append('\\').append(c);
+		else if(c=='\n')
+			result.append("\\n");
+		else if(c=='\t')
+			result.append("\\t");
+		else if(c.unicode()<0x20)
+			result.append(QString("\\u%1").arg(c.unicode(),4,16,QChar('0')));
+		else
+			result.append(c);
+	}
+	return result;
+}
+
+/**
+  The diagnostic as a single line JSON object
+*/
+QString Diagnostic::toJson() const
+{
+	QStringList args;
+	foreach(QString a,arguments)
+		args.append(QString("\"%1\"").arg(escape(a)));
+
+	QString severity;
+	switch(getSeverity()) {
+	case Message:
+		severity="message";
+		break;
+	case Warning:
+		severity="warning";
+		break;
+	case Error:
+		severity="error";
+		break;
+	}
+	QString json=QString("{\"code\":\"%1\",\"severity\":\"%2\"").arg(getName(),severity);
+	if(!file.isEmpty())
+		json.append(QString(",\"file\":\"%1\"").arg(escape(file)));
+	if(line>0)
+		json.append(QString(",\"line\":%1").arg(line));
+	json.append(QString(",\"arguments\":[%1],\"message\":\"%2\"}").arg(args.join(","),escape(getMessage())));
+	return json;
+}
@@ -0,0 +1,79 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * A warning or error recorded while parsing or evaluating a script. The
+ * arguments are kept as they are so that the message only needs to be
+ * formatted when it is written out. Echoed text is recorded the same
+ * way so that it stays in order with the warnings.
+ */
+class Diagnostic
+{
+public:
+	enum Severity_e {
+		Message,
+		Warning,
+		Error
+	};
+
+	enum Code_e {
+		SyntaxError,
+		IllegalToken,
+		FileMissing,
+		ModuleMissing,
+		FunctionMissing,
+		ModuleReturn,
+		GlobalReturn,
+		ConstantAltered,
+		ParametricAltered,
+		ConstantRedeclared,
+		ParametricRedeclared,
+		AdditionalCommas,
+		BuildPlatform,
+		RangeLimited,
+		RangeUndefined,
+		Echo
+	};
+
+	Diagnostic(Code_e,QStringList=QStringList());
+	void setLocation(QString,int);
+	Code_e getCode() const;
+	Severity_e getSeverity() const;
+	QString getFile() const;
+	int getLine() const;
+	QStringList getArguments() const;
+	QString getName() const;
+	QString getMessage() const;
+	QString toJson() const;
+private:
+	friend class DiagnosticSink;
+	Code_e code;
+	QString file;
+	int line;
+	QStringList arguments;
+	Diagnostic* next;
+};
+
+#endif // DIAGNOSTIC_H
@@ -0,0 +1,54 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "diagnosticsink.h"
+
+DiagnosticSink::DiagnosticSink() : head(NULL)
+{
+}
+
+DiagnosticSink::~DiagnosticSink()
+{
+	qDeleteAll(takeAll());
+}
+
+/**
+  Takes ownership of the diagnostic. Can be called from any thread.
+*/
+void DiagnosticSink::report(Diagnostic* d)
+{
+	Diagnostic* h;
+	do {
+		h=head;
+		d->next=h;
+	} while(!head.testAndSetOrdered(h,d));
+}
+
+/**
+  Returns the diagnostics reported since the last call, oldest first. The
+  caller takes ownership of them.
+*/
+QList<Diagnostic*> DiagnosticSink::takeAll()
+{
+	QList<Diagnostic*> result;
+	Diagnostic* d=head.fetchAndStoreOrdered(NULL);
+	for(; d; d=d->next)
+		result.prepend(d);
+	return result;
+}
@@ -0,0 +1,43 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DIAGNOSTICSINK_H
+#define DIAGNOSTICSINK_H
+
+#include <QAtomicPointer>
+#include <QList>
+#include "diagnostic.h"
+
+/**
+ * Collects diagnostics from any number of threads without locking. The
+ * consumer takes everything reported so far, in the order it was
+ * reported, and formats it away from the evaluation.
+ */
+class DiagnosticSink
+{
+public:
+	DiagnosticSink();
+	~DiagnosticSink();
+	void report(Diagnostic*);
+	QList<Diagnostic*> takeAll();
+private:
+	QAtomicPointer<Diagnostic> head;
+};
+
+#endif // DIAGNOSTICSINK_H
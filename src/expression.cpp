@@ -20,12 +20,29 @@
 
 Expression::Expression()
 {
+	lineNumber=0;
 }
 
 Expression::~Expression()
 {
 }
 
+void Expression::setLocation(QString f,int l)
+{
+	sourceFile=f;
+	lineNumber=l;
+}
+
+QString Expression::getSourceFile() const
+{
+	return sourceFile;
+}
+
+int Expression::getLineNumber() const
+{
+	return lineNumber;
+}
+
 QString Expression::getOpString() const
 {
 	QString result;
@@ -61,8 +61,13 @@ public:
 	void setOp(Operator_e);
 	QString getOpString() const;
 	bool postFix();
+	void setLocation(QString,int);
+	QString getSourceFile() const;
+	int getLineNumber() const;
 private:
 	Operator_e op;
+	QString sourceFile;
+	int lineNumber;
 };
 
 #endif // EXPRESSION_H
@@ -17,18 +17,20 @@
  */
 
 #include "function.h"
+#include "symboltable.h"
 #include "functionscope.h"
 #include "context.h"
 
 Function::Function()
 {
+	symbol=0;
 	scope=NULL;
 }
 
 Function::Function(QString n)
 {
+	symbol=SymbolTable::getInstance()->intern(n);
 	scope=NULL;
-	name=n;
 }
 
 Function::~Function()
@@ -41,12 +43,17 @@ Function::~Function()
 
 QString Function::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Function::getSymbol() const
+{
+	return this->symbol;
 }
 
 void Function::setName(QString name)
 {
-	this->name = name;
+	this->symbol = SymbolTable::getInstance()->intern(name);
 }
 
 
@@ -90,5 +97,5 @@ void Function::addParameter(QString name)
 Value *Function::getParameterArgument(Context* ctx, int index)
 {
 	Parameter* p = parameters.at(index);
-	return ctx->getArgument(index,p->getName());
+	return ctx->getArgument(index,p);
 }
@@ -36,6 +36,7 @@ public:
 	Function(QString);
 	~Function();
 	QString getName() const;
+	int getSymbol() const;
 	void setName(QString);
 	QList<Parameter*> getParameters() const;
 	void setParameters(QList<Parameter*>);
@@ -47,7 +48,7 @@ protected:
 	void addParameter(QString);
 	Value* getParameterArgument(Context*,int);
 private:
-	QString name;
+	int symbol;
 	QList<Parameter*> parameters;
 	Scope* scope;
 };
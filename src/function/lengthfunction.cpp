@@ -12,7 +12,7 @@ Value* LengthFunction::evaluate(Context* ctx)
 {
 	VectorValue* vecVal=dynamic_cast<VectorValue*>(getParameterArgument(ctx,0));
 	if(vecVal) {
-		return new NumberValue(vecVal->getChildren().count());
+		return new NumberValue(vecVal->size());
 	}
 	TextValue* txtVal=dynamic_cast<TextValue*>(getParameterArgument(ctx,0));
 	if(txtVal) {
@@ -17,10 +17,14 @@
  */
 
 #include "randfunction.h"
-#include "vectorvalue.h"
+#include "packedvectorvalue.h"
 #include "numbervalue.h"
-#include <stdlib.h>
-#include <time.h>
+#include "random.h"
+#include <math.h>
+#include <string.h>
+
+//The most numbers drawn by one call, well within what a vector can hold
+static const double MaxCount=16777216.0;
 
 RandFunction::RandFunction() : Function("rands")
 {
@@ -30,14 +34,16 @@ RandFunction::RandFunction() : Function("rands")
 	addParameter("seed");
 }
 
-static double frand()
+/* Numbers in range are used as they are, anything else that
+ * cannot be converted, such as nan or inf, is hashed instead. */
+static quint64 toSeed(double s)
 {
-	return rand()/(double(RAND_MAX)+1);
-}
+	if(fabs(s)<9.2e18)
+		return (quint64)(qint64)s;
 
-static double frand(double min, double max)
-{
-	return (min>max)?frand()*(min-max)+max:frand()*(max-min)+min;
+	quint64 bits;
+	memcpy(&bits,&s,sizeof(bits));
+	return Random::mix(bits);
 }
 
 Value* RandFunction::evaluate(Context* ctx)
@@ -50,19 +56,19 @@ Value* RandFunction::evaluate(Context* ctx)
 	NumberValue* maxVal=dynamic_cast<NumberValue*>(getParameterArgument(ctx,1));
 	if(maxVal)
 		max=maxVal->getNumber();
-	double count=1;
+	int count=1;
 	NumberValue* countVal=dynamic_cast<NumberValue*>(getParameterArgument(ctx,2));
-	if(countVal)
-		count=countVal->getNumber();
+	if(countVal) {
+		double c=ceil(countVal->getNumber());
+		count=(c>0)?(int)qMin(c,MaxCount):0;
+	}
+	quint64 seed;
 	NumberValue* seedVal=dynamic_cast<NumberValue*>(getParameterArgument(ctx,3));
 	if(seedVal)
-		srand((unsigned int)seedVal->getNumber());
+		seed=toSeed(seedVal->getNumber());
 	else
-		srand((unsigned int)time(0));
-
-	QList<Value*> results;
-	for(int i=0; i<count; ++i)
-		results.append(new NumberValue(frand(min,max)));
+		seed=ctx->nextSeed();
 
-	return new VectorValue(results);
+	Random random(seed);
+	return new PackedVectorValue(random.fill(count,min,max));
 }
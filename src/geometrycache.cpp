@@ -0,0 +1,60 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "geometrycache.h"
+
+GeometryCache::GeometryCache(int size) : primitives(size)
+{
+	hits=0;
+	misses=0;
+}
+
+Primitive* GeometryCache::get(QByteArray digest)
+{
+	QMutexLocker locker(&lock);
+	Primitive* p=primitives.object(digest);
+	if(!p) {
+		misses++;
+		return NULL;
+	}
+	hits++;
+	return p->copy();
+}
+
+void GeometryCache::insert(QByteArray digest,Primitive* p)
+{
+	QMutexLocker locker(&lock);
+	if(p && !primitives.contains(digest))
+		primitives.insert(digest,p->copy());
+}
+
+void GeometryCache::clear()
+{
+	QMutexLocker locker(&lock);
+	primitives.clear();
+}
+
+int GeometryCache::getHits() const
+{
+	return hits;
+}
+
+int GeometryCache::getMisses() const
+{
+	return misses;
+}
@@ -0,0 +1,50 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GEOMETRYCACHE_H
+#define GEOMETRYCACHE_H
+
+#include <QCache>
+#include <QByteArray>
+#include <QMutex>
+#include "primitive.h"
+
+/**
+  Keeps the primitives of evaluated subtrees, keyed on the digest of
+  their structure, so that unchanged parts of a script are not evaluated
+  again. The primitives handed out share their representation with the
+  cached ones, so the cache should only serve one evaluation at a time,
+  and anything passed to another thread must be a deep copy.
+*/
+class GeometryCache
+{
+public:
+	GeometryCache(int);
+	Primitive* get(QByteArray);
+	void insert(QByteArray,Primitive*);
+	void clear();
+	int getHits() const;
+	int getMisses() const;
+private:
+	QCache<QByteArray,Primitive> primitives;
+	QMutex lock;
+	int hits;
+	int misses;
+};
+
+#endif // GEOMETRYCACHE_H
@@ -108,8 +108,12 @@ void GLView::setShowPrintArea(bool print)
 	updateGL();
 }
 
+/* The view owns the renderer, the old one is deleted while the context
+ * is current so that it can free its display lists. */
 void GLView::setRenderer(Renderer* r)
 {
+	makeCurrent();
+	delete render;
 	render=r;
 	updateGL();
 }
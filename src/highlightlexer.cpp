@@ -0,0 +1,531 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "highlightlexer.h"
+#include "reporter.h"
+
+extern void* lexerinit(AbstractTokenBuilder*,Reporter*);
+extern void lexerinput(void*,QString,bool);
+extern void lexerdestroy(void*);
+extern int lexerlex(void*);
+extern void lexerbegin(void*);
+extern void lexercomment(void*);
+extern void lexercodedoc(void*);
+extern int lexerget_leng(void*);
+#define YY_CONTINUE 1;
+
+HighlightLexer::HighlightLexer()
+{
+	keywordFormat.setForeground(Qt::darkBlue);
+	keywordFormat.setFontWeight(QFont::Bold);
+
+	numberFormat.setForeground(Qt::red);
+
+	operatorFormat.setForeground(Qt::darkMagenta);
+
+	errorFormat.setBackground(Qt::red);
+
+	stringFormat.setForeground(Qt::darkGreen);
+
+	codeDocFormat.setForeground(Qt::darkBlue);
+
+	codeDocParamFormat.setForeground(Qt::blue);
+	codeDocParamFormat.setFontWeight(QFont::Bold);
+
+	scanner=lexerinit(this,NULL);
+	formats=NULL;
+}
+
+HighlightLexer::~HighlightLexer()
+{
+	lexerdestroy(scanner);
+}
+
+int HighlightLexer::lex(const QString& text,int state,QList<QTextLayout::FormatRange>& result)
+{
+	startIndex=0;
+	startState=state;
+	/* A line that lexes without any state changes, such as a blank
+	 line inside a comment, carries the previous state forward. */
+	currentState=state;
+	formats=&result;
+	lexerinput(scanner,text,false);
+
+	//Force lexer into correct state
+	switch(state) {
+	case Comment:
+		lexercomment(scanner);
+		break;
+	case CodeDoc:
+		lexercodedoc(scanner);
+		break;
+	default:
+		lexerbegin(scanner);
+		break;
+	}
+
+	while(nextToken());
+
+	formats=NULL;
+	return currentState;
+}
+
+void HighlightLexer::setFormat(int start,int count,const QTextCharFormat& format)
+{
+	QTextLayout::FormatRange range;
+	range.start=start;
+	range.length=count;
+	range.format=format;
+	formats->append(range);
+}
+
+void HighlightLexer::setCurrentBlockState(int state)
+{
+	currentState=state;
+}
+
+int HighlightLexer::previousBlockState() const
+{
+	return startState;
+}
+
+int HighlightLexer::nextToken()
+{
+	int res=lexerlex(scanner);
+	startIndex+=lexerget_leng(scanner);
+	return res;
+}
+
+int HighlightLexer::getPosition() const
+{
+	return startIndex;
+}
+
+int HighlightLexer::getLineNumber() const
+{
+	return 1; /*TODO for now we don't really care what line
+	we are on for syntax highlighting */
+}
+
+void HighlightLexer::buildIncludeStart()
+{
+	setFormat(startIndex,lexerget_leng(scanner)-1,keywordFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+void HighlightLexer::buildIncludeFile(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+void HighlightLexer::buildIncludePath(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildIncludeFinish()
+{
+	startIndex++;
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildUseStart()
+{
+	setFormat(startIndex,lexerget_leng(scanner)-1,keywordFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildUse(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildUseFinish()
+{
+	startIndex++;
+}
+
+void HighlightLexer::buildImportStart()
+{
+	setFormat(startIndex,lexerget_leng(scanner)-1,keywordFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildImport(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildImportFinish()
+{
+	startIndex++;
+}
+
+unsigned int HighlightLexer::buildModule()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildFunction()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildTrue()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildFalse()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildUndef()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildConst()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildParam()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildIf()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAs()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildElse()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildFor()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildReturn()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildLessEqual()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildGreatEqual()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildEqual()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildNotEqual()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAnd()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildOr()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildComponentwiseMultiply()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildComponentwiseDivide()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildIncrement()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildDecrement()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAddAssign()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildSubtractAssign()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildOuterProduct()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildNamespace()
+{
+	setFormat(startIndex,lexerget_leng(scanner),keywordFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAssign()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAdd()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildSubtract()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildTernaryCondition()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildTernaryAlternate()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildNot()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildMultiply()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildDivide()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildModulus()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildConcatenate()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildAppend()
+{
+	setFormat(startIndex,lexerget_leng(scanner),operatorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildLegalChar(unsigned int)
+{
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildIllegalChar()
+{
+	setFormat(startIndex,lexerget_leng(scanner),errorFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildNumber(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),numberFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildIdentifier(QString)
+{
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildStringStart()
+{
+	stringStart=startIndex;
+	startIndex++;
+}
+
+void HighlightLexer::buildString(QChar)
+{
+	startIndex++;
+}
+
+void HighlightLexer::buildString(QString)
+{
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildStringFinish()
+{
+	int stringLen=(startIndex+1)-stringStart;
+	setFormat(stringStart,stringLen,stringFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildCommentStart()
+{
+	setCurrentBlockState(Comment);
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildComment(QString)
+{
+	if(previousBlockState()==Comment)
+		setCurrentBlockState(Comment);
+
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildCommentFinish()
+{
+	setCurrentBlockState(Initial);
+	setFormat(startIndex,lexerget_leng(scanner),stringFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildCodeDocStart()
+{
+	setCurrentBlockState(CodeDoc);
+	setFormat(startIndex,lexerget_leng(scanner),codeDocFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildCodeDoc(QString)
+{
+	if(previousBlockState()==CodeDoc)
+		setCurrentBlockState(CodeDoc);
+
+	setFormat(startIndex,lexerget_leng(scanner),codeDocFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildCodeDoc()
+{
+	if(previousBlockState()==CodeDoc)
+		setCurrentBlockState(CodeDoc);
+
+	setFormat(startIndex,lexerget_leng(scanner),codeDocFormat);
+	startIndex+=lexerget_leng(scanner);
+}
+
+unsigned int HighlightLexer::buildCodeDocParam(QString)
+{
+	setFormat(startIndex,lexerget_leng(scanner),codeDocParamFormat);
+	return YY_CONTINUE;
+}
+
+unsigned int HighlightLexer::buildCodeDocFinish()
+{
+	setCurrentBlockState(Initial);
+	setFormat(startIndex,lexerget_leng(scanner),codeDocFormat);
+	return YY_CONTINUE;
+}
+
+void HighlightLexer::buildWhiteSpaceError()
+{
+	setFormat(startIndex,lexerget_leng(scanner),errorFormat);
+}
+
+void HighlightLexer::buildWhiteSpace()
+{
+	startIndex+=lexerget_leng(scanner);
+}
+
+void HighlightLexer::buildNewLine()
+{
+}
+
+void HighlightLexer::buildFileStart(QDir)
+{
+}
+
+void HighlightLexer::buildFileFinish()
+{
+}
@@ -0,0 +1,167 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QFileInfo>
+#include <QDir>
+#include <QImage>
+#include <QVector>
+#include "imagerenderer.h"
+#include "meshrenderer.h"
+#include "preferences.h"
+
+#if USE_OSMESA
+#include <GL/osmesa.h>
+#include <GL/glu.h>
+#endif
+
+ImageRenderer::ImageRenderer()
+{
+	width=800;
+	height=600;
+}
+
+void ImageRenderer::setSize(int w,int h)
+{
+	width=w;
+	height=h;
+}
+
+void ImageRenderer::addView(double rx,double rz,double x,double z,double d)
+{
+	View v;
+	v.rotateX=rx;
+	v.rotateZ=rz;
+	v.x=x;
+	v.z=z;
+	v.distance=d;
+	views.append(v);
+}
+
+/* Offscreen rendering is done with OSMesa so that it needs neither a
+ * display nor a graphics card. */
+bool ImageRenderer::isAvailable()
+{
+#if USE_OSMESA
+	return true;
+#else
+	return false;
+#endif
+}
+
+QString ImageRenderer::getFileName(QString file,int view) const
+{
+	if(views.size()<2)
+		return file;
+	QFileInfo info(file);
+	return info.dir().filePath(QString("%1-%2.%3").arg(info.completeBaseName()).arg(view+1).arg(info.suffix()));
+}
+
+/**
+  Renders the triangles given as indices into the vertices, both in the
+  form that CGALExport::exportMesh gives them, so that the result does
+  not have to be converted again for display.
+*/
+bool ImageRenderer::render(const QVector<double>& vertices,const QVector<int>& triangles,QString file)
+{
+	if(views.isEmpty()) {
+		Preferences* p=Preferences::getInstance();
+		addView(p->getDefaultRotationX(),p->getDefaultRotationZ(),
+			p->getDefaultX(),p->getDefaultZ(),p->getDefaultDistance());
+	}
+
+	//Each triangle gets its own vertices so that it can be flat shaded
+	MeshRenderer mesh;
+	for(int i=0; i+2<triangles.size(); i+=3) {
+		const double* a=vertices.constData()+triangles.at(i)*3;
+		const double* b=vertices.constData()+triangles.at(i+1)*3;
+		const double* c=vertices.constData()+triangles.at(i+2)*3;
+		double ux=b[0]-a[0],uy=b[1]-a[1],uz=b[2]-a[2];
+		double vx=c[0]-a[0],vy=c[1]-a[1],vz=c[2]-a[2];
+		double nx=uy*vz-uz*vy,ny=uz*vx-ux*vz,nz=ux*vy-uy*vx;
+		int first=mesh.appendVertex(a[0],a[1],a[2],nx,ny,nz);
+		mesh.appendVertex(b[0],b[1],b[2],nx,ny,nz);
+		mesh.appendVertex(c[0],c[1],c[2],nx,ny,nz);
+		mesh.appendTriangle(first,first+1,first+2,true);
+	}
+
+#if USE_OSMESA
+	OSMesaContext context=OSMesaCreateContextExt(OSMESA_RGBA,24,0,0,NULL);
+	if(!context)
+		return false;
+	QVector<GLubyte> buffer(width*height*4);
+	if(!OSMesaMakeCurrent(context,buffer.data(),GL_UNSIGNED_BYTE,width,height)) {
+		OSMesaDestroyContext(context);
+		return false;
+	}
+	//Have the first row of the buffer be the top of the image
+	OSMesaPixelStore(OSMESA_Y_UP,0);
+
+	//The same lighting and projection as GLView
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(1.0,1.0,1.0,0.0);
+	GLfloat light_diffuse[]= {1.0,1.0,1.0,1.0};
+	GLfloat light_position0[]= {-1.0,-1.0,+1.0,0.0};
+	GLfloat light_position1[]= {+1.0,+1.0,-1.0,0.0};
+	glLightfv(GL_LIGHT0,GL_DIFFUSE,light_diffuse);
+	glLightfv(GL_LIGHT0,GL_POSITION,light_position0);
+	glEnable(GL_LIGHT0);
+	glLightfv(GL_LIGHT1,GL_DIFFUSE,light_diffuse);
+	glLightfv(GL_LIGHT1,GL_POSITION,light_position1);
+	glEnable(GL_LIGHT1);
+	glEnable(GL_LIGHTING);
+	glEnable(GL_NORMALIZE);
+	glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+	glEnable(GL_COLOR_MATERIAL);
+
+	glViewport(0,0,width,height);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluPerspective(45.0,(GLdouble)width/(GLdouble)height,+10.0,+100000.0);
+
+	bool ok=true;
+	for(int i=0; i<views.size(); i++) {
+		const View& v=views.at(i);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+		glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+		gluLookAt(-v.x,-v.distance,-v.z,-v.x,0.0,-v.z,0.0,0.0,1.0);
+		glRotated(v.rotateX,1.0,0.0,0.0);
+		glRotated(v.rotateZ,0.0,0.0,1.0);
+		mesh.draw(false,false);
+		glFinish();
+
+		QImage image(width,height,QImage::Format_ARGB32);
+		const GLubyte* pixel=buffer.constData();
+		for(int y=0; y<height; y++) {
+			for(int x=0; x<width; x++) {
+				image.setPixel(x,y,qRgba(pixel[0],pixel[1],pixel[2],pixel[3]));
+				pixel+=4;
+			}
+		}
+		if(!image.save(getFileName(file,i),"PNG"))
+			ok=false;
+	}
+
+	OSMesaDestroyContext(context);
+	return ok;
+#else
+	Q_UNUSED(file);
+	return false;
+#endif
+}
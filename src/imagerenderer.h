@@ -0,0 +1,54 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef IMAGERENDERER_H
+#define IMAGERENDERER_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**
+  Renders a mesh to PNG images without a display, from one or
+  more views given by the same parameters that GLView::getViewport
+  returns. When there is more than one view the images are numbered.
+*/
+class ImageRenderer
+{
+public:
+	ImageRenderer();
+	void setSize(int,int);
+	void addView(double,double,double,double,double);
+	bool render(const QVector<double>&,const QVector<int>&,QString);
+	static bool isAvailable();
+private:
+	struct View {
+		double rotateX;
+		double rotateZ;
+		double x;
+		double z;
+		double distance;
+	};
+	QString getFileName(QString,int) const;
+	int width;
+	int height;
+	QList<View> views;
+};
+
+#endif // IMAGERENDERER_H
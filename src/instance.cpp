@@ -17,9 +17,11 @@
  */
 
 #include "instance.h"
+#include "symboltable.h"
 
 Instance::Instance()
 {
+	symbol=0;
 	type = Default;
 }
 
@@ -34,12 +36,17 @@ Instance::~Instance()
 
 void Instance::setName(QString name)
 {
-	this->name = name;
+	this->symbol = SymbolTable::getInstance()->intern(name);
 }
 
 QString Instance::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Instance::getSymbol() const
+{
+	return this->symbol;
 }
 
 void Instance::setArguments(QList<Argument*> args)
@@ -39,6 +39,7 @@ public:
 	~Instance();
 	void setName(QString);
 	QString getName() const;
+	int getSymbol() const;
 	void setArguments(QList<Argument*>);
 	QList<Argument*> getArguments() const;
 	void setChildren(QList <Statement*> childs);
@@ -49,7 +50,7 @@ public:
 	QString getNamespace() const;
 	void accept(TreeVisitor&);
 private:
-	QString name;
+	int symbol;
 	QList<Argument*> arguments;
 	QList<Statement*> children;
 	Type_e type;
@@ -1,7 +1,9 @@
 #include "invocation.h"
+#include "symboltable.h"
 
 Invocation::Invocation()
 {
+	symbol=0;
 }
 
 Invocation::~Invocation()
@@ -10,12 +12,17 @@ Invocation::~Invocation()
 
 void Invocation::setName(QString name)
 {
-	this->name = name;
+	this->symbol = SymbolTable::getInstance()->intern(name);
 }
 
 QString Invocation::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Invocation::getSymbol() const
+{
+	return this->symbol;
 }
 
 void Invocation::setNamespace(QString name)
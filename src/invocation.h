@@ -31,13 +31,14 @@ public:
 
 	void setName(QString);
 	QString getName() const;
+	int getSymbol() const;
 	void setNamespace(QString);
 	QString getNamespace() const;
 	void setArguments(QList<Argument*>);
 	QList<Argument*> getArguments() const;
 	void accept(TreeVisitor&);
 private:
-	QString name;
+	int symbol;
 	QString nameSpace;
 	QList<Argument*> arguments;
 };
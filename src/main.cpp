@@ -20,6 +20,10 @@
 #include <QTextStream>
 #include "mainwindow.h"
 #include "worker.h"
+#include "projectbuilder.h"
+#include "batchrunner.h"
+#include "renderserver.h"
+#include "imagerenderer.h"
 #include "getopt.h"
 #include "preferences.h"
 
@@ -34,11 +38,6 @@ static void version(QTextStream& output)
 
 static int showUi(int argc, char* argv[],QString filename)
 {
-	QCoreApplication::setOrganizationName("rapcad");
-	QCoreApplication::setOrganizationDomain("rapcad.org");
-	QCoreApplication::setApplicationName("RapCAD");
-	QCoreApplication::setApplicationVersion(TOSTRING(RAPCAD_VERSION));
-
 	QApplication a(argc, argv);
 	MainWindow w;
 
@@ -56,11 +55,26 @@ int main(int argc, char* argv[])
 {
 	int opt;
 	QString outputFile;
+	QString projectFile;
+	QString traceFile;
+	QString watchDirectory;
+	QString serverName="rapcad";
 	bool print=false;
 	bool useGUI=true;
+	bool batch=false;
+	int jobs=0;
+	QString imageFile;
+	QString diagnosticsFile;
+	ImageRenderer image;
 	QTextStream out(stdout);
 
-	while((opt = getopt(argc, argv, "o:p::v")) != -1) {
+	//The command line also reads the preferences, for the default view
+	QCoreApplication::setOrganizationName("rapcad");
+	QCoreApplication::setOrganizationDomain("rapcad.org");
+	QCoreApplication::setApplicationName("RapCAD");
+	QCoreApplication::setApplicationVersion(TOSTRING(RAPCAD_VERSION));
+
+	while((opt = getopt(argc, argv, "o:p::vm:bj:d:s:t:i:c:g:e:")) != -1) {
 		switch(opt) {
 		case 'o':
 			useGUI=false;
@@ -72,17 +86,90 @@ int main(int argc, char* argv[])
 		case 'v':
 			version(out);
 			break;
+		case 'm':
+			useGUI=false;
+			projectFile=QString(optarg);
+			break;
+		case 'b':
+			useGUI=false;
+			batch=true;
+			break;
+		case 'j':
+			jobs=QString(optarg).toInt();
+			break;
+		case 'd':
+			useGUI=false;
+			watchDirectory=QString(optarg);
+			break;
+		case 's':
+			serverName=QString(optarg);
+			break;
+		case 't':
+			useGUI=false;
+			traceFile=QString(optarg);
+			break;
+		case 'e':
+			useGUI=false;
+			diagnosticsFile=QString(optarg);
+			break;
+		case 'i':
+			useGUI=false;
+			imageFile=QString(optarg);
+			break;
+		case 'c': {
+			QStringList v=QString(optarg).split(',');
+			if(v.size()!=5) {
+				out << "A view is given as rx,rz,x,z,distance\n";
+				return 1;
+			}
+			image.addView(v.at(0).toDouble(),v.at(1).toDouble(),v.at(2).toDouble(),v.at(3).toDouble(),v.at(4).toDouble());
+			break;
+		}
+		case 'g': {
+			QStringList g=QString(optarg).split('x');
+			if(g.size()!=2 || g.at(0).toInt()<=0 || g.at(1).toInt()<=0) {
+				out << "An image size is given as widthxheight\n";
+				return 1;
+			}
+			image.setSize(g.at(0).toInt(),g.at(1).toInt());
+			break;
+		}
 		}
 	}
 
 	QString inputFile;
 	inputFile=QString(argv[optind]);
 
-	if(!useGUI) {
+	if(!projectFile.isEmpty()) {
+		ProjectBuilder p(out);
+		p.setExecutable(QString(argv[0]));
+		p.build(projectFile);
+		return 0;
+	} else if(!watchDirectory.isEmpty()) {
+		QCoreApplication a(argc,argv);
+		RenderServer r(out);
+		r.setOutputTemplate(outputFile);
+		if(!r.start(watchDirectory,serverName))
+			return 1;
+		return a.exec();
+	} else if(batch) {
+		QStringList inputs;
+		for(int i=optind; i<argc; i++)
+			inputs.append(QString(argv[i]));
+		BatchRunner r(out);
+		r.setJobs(jobs);
+		r.setOutputTemplate(outputFile);
+		return r.run(inputs)>0?1:0;
+	} else if(!useGUI) {
 		Worker b(out);
 		b.setup(inputFile,outputFile,print);
+		b.setTraceFile(traceFile);
+		b.setDiagnosticsFile(diagnosticsFile);
+		if(!imageFile.isEmpty())
+			b.setImage(imageFile,&image);
 		b.evaluate();
-		return 0;
+		//Let whoever ran us, such as the project builder, see a failed export
+		return (outputFile.isEmpty()||b.isExported())?0:1;
 	} else {
 		return showUi(argc,argv,inputFile);
 	}
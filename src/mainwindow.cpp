@@ -52,6 +52,7 @@ MainWindow::~MainWindow()
 	delete console;
 	delete output;
 	delete worker;
+	delete geometry;
 	delete preferencesDialog;
 	delete ui;
 }
@@ -158,6 +159,7 @@ void MainWindow::setupActions()
 	ui->actionCopy->setIcon(QIcon::fromTheme("edit-copy"));
 	ui->actionPaste->setIcon(QIcon::fromTheme("edit-paste"));
 	ui->actionCompileAndRender->setIcon(QIcon::fromTheme("system-run"));
+	ui->actionStop->setIcon(QIcon::fromTheme("process-stop"));
 	ui->actionGenerateGcode->setIcon(QIcon::fromTheme("format-justify-fill"));
 	ui->actionPreferences->setIcon(QIcon::fromTheme("document-properties"));
 
@@ -188,6 +190,7 @@ void MainWindow::setupActions()
 	connect(ui->actionShowPrintArea,SIGNAL(triggered(bool)),ui->view,SLOT(setShowPrintArea(bool)));
 	connect(ui->actionShowRulers,SIGNAL(triggered(bool)),ui->view,SLOT(setShowRulers(bool)));
 	connect(ui->actionCompileAndRender,SIGNAL(triggered()),this,SLOT(compileAndRender()));
+	connect(ui->actionStop,SIGNAL(triggered()),this,SLOT(stopRender()));
 	connect(ui->actionPreferences,SIGNAL(triggered()),this,SLOT(showPreferences()));
 	connect(ui->actionExportAsciiSTL,SIGNAL(triggered()),this,SLOT(exportAsciiSTL()));
 	connect(ui->actionExportOFF,SIGNAL(triggered()),this,SLOT(exportOFF()));
@@ -311,7 +314,7 @@ void MainWindow::setupTabs(QTabWidget* tabWidget)
 
 void MainWindow::setupConsole()
 {
-	QTextEdit* c=(QTextEdit*)ui->plainTextEdit;
+	QPlainTextEdit* c=ui->plainTextEdit;
 
 	QFont font;
 	font.setFamily("Courier");
@@ -319,9 +322,16 @@ void MainWindow::setupConsole()
 	font.setPointSize(8);
 	c->setFont(font);
 	console=new TextEditIODevice(c,this);
+	console->setMaximumLines(10000);
 	output=new QTextStream(console);
 	worker=new BackgroundWorker(*output);
+	geometry=new GeometryCache(4096);
+	worker->setGeometryCache(geometry);
+	rendering=false;
 	connect(worker,SIGNAL(done(Primitive*)),this,SLOT(evaluationDone(Primitive*)));
+	connect(worker,SIGNAL(finished()),this,SLOT(evaluationFinished()));
+	qRegisterMetaType<Renderer*>("Renderer*");
+	connect(worker,SIGNAL(preview(Renderer*)),this,SLOT(evaluationPreview(Renderer*)));
 }
 
 void MainWindow::clipboardDataChanged()
@@ -480,21 +490,38 @@ CodeEditor* MainWindow::getEditor(int i)
 
 void MainWindow::compileAndRender()
 {
-	//Stop the syntax highlighter to prevent a crash
-	//It will start again automatically.
 	CodeEditor* e=currentEditor();
-	e->stopHighlighting();
 
 	if(maybeSave(true)) {
 		QString file=e->getFileName();
-		if(!file.isEmpty()) {
-			worker->setup(file);
-			worker->evaluate();
-			ui->actionCompileAndRender->setEnabled(false);
+		if(file.isEmpty())
+			return;
+
+		if(rendering) {
+			/* Start again once the running render has stopped, what it
+			 * has finished so far is in the geometry cache. */
+			pendingFile=file;
+			worker->cancel();
+		} else {
+			startRender(file);
 		}
 	}
 }
 
+void MainWindow::startRender(QString file)
+{
+	worker->setup(file);
+	worker->evaluate();
+	rendering=true;
+	ui->actionStop->setEnabled(true);
+}
+
+void MainWindow::stopRender()
+{
+	pendingFile.clear();
+	worker->cancel();
+}
+
 void MainWindow::evaluationDone(Primitive* n)
 {
 	if(n) {
@@ -502,7 +529,25 @@ void MainWindow::evaluationDone(Primitive* n)
 		Renderer* r = worker->getRenderer(primitive);
 		ui->view->setRenderer(r);
 	}
-	ui->actionCompileAndRender->setEnabled(true);
+}
+
+/* The next render is only started once the thread of the last one has
+ * finished, rather than waiting for it here. */
+void MainWindow::evaluationFinished()
+{
+	rendering=false;
+	ui->actionStop->setEnabled(false);
+
+	if(!pendingFile.isEmpty()) {
+		QString file=pendingFile;
+		pendingFile.clear();
+		startRender(file);
+	}
+}
+
+void MainWindow::evaluationPreview(Renderer* r)
+{
+	ui->view->setRenderer(r);
 }
 
 void MainWindow::undo()
@@ -560,10 +605,9 @@ void MainWindow::showBuiltins()
 
 	connect(e,SIGNAL(copyAvailable(bool)), ui->actionCopy, SLOT(setEnabled(bool)));
 
-	QTextEdit* c=(QTextEdit*)e;
-	QIODevice* t=new TextEditIODevice(c,this);
+	QIODevice* t=new TextEditIODevice(e,this);
 	QTextStream out(t);
-	BuiltinCreator* b = BuiltinCreator::getInstance(out);
+	BuiltinCreator* b = BuiltinCreator::getInstance();
 	b->generateDocs(out);
 	out.flush();
 	delete t;
@@ -61,7 +61,10 @@ private slots:
 	bool closeFile(int);
 	void openFile();
 	void compileAndRender();
+	void stopRender();
 	void evaluationDone(Primitive*);
+	void evaluationFinished();
+	void evaluationPreview(Renderer*);
 	void setTabTitle(const QString&);
 	void undo();
 	void redo();
@@ -85,12 +88,16 @@ private:
 	CodeEditor* getEditor(int i);
 	void disableActions(CodeEditor*);
 	bool saveSelectedFiles(QList<QString>);
+	void startRender(QString);
 
 	Ui::MainWindow* ui;
 	QStandardItemModel* myModel;
 	QTextStream* output;
 	TextEditIODevice* console;
 	BackgroundWorker* worker;
+	GeometryCache* geometry;
+	bool rendering;
+	QString pendingFile;
 	PreferencesDialog* preferencesDialog;
 	Primitive* primitive;
 };
@@ -0,0 +1,503 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+#include "meshrenderer.h"
+#include "preferences.h"
+
+//Elements in a batch, larger groups are split in two
+static const int batchSize=4096;
+//Size in pixels below which the cells of a coarser level are not noticed
+static const double tolerance=1.0;
+
+MeshRenderer::MeshRenderer() :
+	vertexBuffer(QGLBuffer::VertexBuffer),
+	normalBuffer(QGLBuffer::VertexBuffer),
+	indexBuffer(QGLBuffer::IndexBuffer)
+{
+	Preferences* p=Preferences::getInstance();
+	markedVertexColor=p->getMarkedVertexColor();
+	vertexColor=p->getVertexColor();
+	markedEdgeColor=p->getMarkedEdgeColor();
+	edgeColor=p->getEdgeColor();
+	markedFacetColor=p->getMarkedFacetColor();
+	facetColor=p->getFacetColor();
+	vertexSize=p->getVertexSize();
+	edgeSize=p->getEdgeSize();
+	initialised=false;
+	buffered=false;
+}
+
+int MeshRenderer::appendVertex(double x,double y,double z)
+{
+	return appendVertex(x,y,z,0.0,0.0,0.0);
+}
+
+int MeshRenderer::appendVertex(double x,double y,double z,double nx,double ny,double nz)
+{
+	vertices.append(x);
+	vertices.append(y);
+	vertices.append(z);
+	normals.append(nx);
+	normals.append(ny);
+	normals.append(nz);
+	return vertices.size()/3-1;
+}
+
+void MeshRenderer::appendTriangle(int a,int b,int c,bool mark)
+{
+	QVector<GLuint>& e=elements[mark?MarkedFacets:Facets];
+	e.append(a);
+	e.append(b);
+	e.append(c);
+}
+
+void MeshRenderer::appendEdge(int a,int b,bool mark)
+{
+	QVector<GLuint>& e=elements[mark?MarkedEdges:Edges];
+	e.append(a);
+	e.append(b);
+}
+
+void MeshRenderer::appendPoint(int a,bool mark)
+{
+	elements[mark?MarkedPoints:Points].append(a);
+}
+
+int MeshRenderer::elementSize(Elements_e type)
+{
+	switch(type) {
+	case Facets:
+	case MarkedFacets:
+		return 3;
+	case Edges:
+	case MarkedEdges:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+/* All the elements go into one index buffer. Each batch has a range
+ * of it for every level and kind of element. */
+void MeshRenderer::init()
+{
+	if(initialised)
+		return;
+	initialised=true;
+
+	QVector<Item> items;
+	for(int t=0; t<ElementTypes; t++) {
+		Elements_e type=(Elements_e)t;
+		int size=elementSize(type);
+		const QVector<GLuint>& e=elements[t];
+		for(int i=0; i+size<=e.size(); i+=size) {
+			Item item;
+			item.type=type;
+			item.first=i;
+			for(int k=0; k<3; k++) {
+				double c=0.0;
+				for(int j=0; j<size; j++)
+					c+=vertices.at(e.at(i+j)*3+k);
+				item.centre[k]=c/size;
+			}
+			items.append(item);
+		}
+	}
+	if(!items.isEmpty())
+		build(items,0,items.size());
+
+	QVector<bool> borders=findBorders(items);
+	for(int i=0; i<batches.size(); i++)
+		for(int level=0; level<Levels; level++)
+			addLevel(items,batches[i],level,borders);
+
+	for(int t=0; t<ElementTypes; t++)
+		elements[t]=QVector<GLuint>();
+
+	buffered=vertexBuffer.create() && normalBuffer.create() && indexBuffer.create();
+	if(!buffered)
+		return;
+
+	vertexBuffer.bind();
+	vertexBuffer.allocate(vertices.constData(),vertices.size()*sizeof(GLfloat));
+	vertexBuffer.release();
+	normalBuffer.bind();
+	normalBuffer.allocate(normals.constData(),normals.size()*sizeof(GLfloat));
+	normalBuffer.release();
+	indexBuffer.bind();
+	indexBuffer.allocate(indices.constData(),indices.size()*sizeof(GLuint));
+	indexBuffer.release();
+
+	//The buffers now hold the only copy of the mesh
+	vertices=QVector<GLfloat>();
+	normals=QVector<GLfloat>();
+	indices=QVector<GLuint>();
+}
+
+/* Splits the items at the median of their centres along the longest
+ * axis until there are few enough to make a batch. */
+int MeshRenderer::build(QVector<Item>& items,int begin,int end)
+{
+	int index=hierarchy.size();
+	hierarchy.append(Bounds());
+
+	Bounds b;
+	if(end-begin<=batchSize) {
+		Batch batch;
+		addBatch(items,begin,end,batch);
+		for(int k=0; k<3; k++) {
+			b.lower[k]=batch.lower[k];
+			b.upper[k]=batch.upper[k];
+		}
+		b.left=-1;
+		b.right=-1;
+		b.batch=batches.size();
+		batches.append(batch);
+	} else {
+		double lower[3],upper[3];
+		for(int k=0; k<3; k++) {
+			lower[k]=upper[k]=items.at(begin).centre[k];
+			for(int i=begin+1; i<end; i++) {
+				lower[k]=fmin(lower[k],items.at(i).centre[k]);
+				upper[k]=fmax(upper[k],items.at(i).centre[k]);
+			}
+		}
+		CentreLess less;
+		less.axis=0;
+		for(int k=1; k<3; k++)
+			if(upper[k]-lower[k]>upper[less.axis]-lower[less.axis])
+				less.axis=k;
+
+		int middle=(begin+end)/2;
+		std::nth_element(items.begin()+begin,items.begin()+middle,items.begin()+end,less);
+		b.batch=-1;
+		b.left=build(items,begin,middle);
+		b.right=build(items,middle,end);
+		const Bounds& l=hierarchy.at(b.left);
+		const Bounds& r=hierarchy.at(b.right);
+		for(int k=0; k<3; k++) {
+			b.lower[k]=fmin(l.lower[k],r.lower[k]);
+			b.upper[k]=fmax(l.upper[k],r.upper[k]);
+		}
+	}
+
+	hierarchy[index]=b;
+	return index;
+}
+
+void MeshRenderer::addBatch(const QVector<Item>& items,int begin,int end,Batch& batch)
+{
+	bool first=true;
+	for(int i=begin; i<end; i++) {
+		const Item& item=items.at(i);
+		for(int j=0; j<elementSize(item.type); j++) {
+			GLuint v=elements[item.type].at(item.first+j);
+			for(int k=0; k<3; k++) {
+				double c=vertices.at(v*3+k);
+				batch.lower[k]=first?c:fmin(batch.lower[k],c);
+				batch.upper[k]=first?c:fmax(batch.upper[k],c);
+			}
+			first=false;
+		}
+	}
+
+	double x=batch.upper[0]-batch.lower[0];
+	double y=batch.upper[1]-batch.lower[1];
+	double z=batch.upper[2]-batch.lower[2];
+	batch.diagonal=sqrt(x*x+y*y+z*z);
+	batch.begin=begin;
+	batch.end=end;
+}
+
+/* The vertices at a position used by the elements of more than one
+ * batch. Vertices are repeated for every facet, so they are matched by
+ * where they fall on a fine grid over the whole mesh, not by index. */
+QVector<bool> MeshRenderer::findBorders(const QVector<Item>& items) const
+{
+	QVector<bool> borders(vertices.size()/3,false);
+	if(hierarchy.isEmpty())
+		return borders;
+
+	const Bounds& whole=hierarchy.at(0);
+	double x=whole.upper[0]-whole.lower[0];
+	double y=whole.upper[1]-whole.lower[1];
+	double z=whole.upper[2]-whole.lower[2];
+	double cell=sqrt(x*x+y*y+z*z)/0x100000;
+
+	//The batch using each position, or -1 once another batch uses it too
+	QHash<quint64,int> owners;
+	for(int b=0; b<batches.size(); b++) {
+		const Batch& batch=batches.at(b);
+		for(int i=batch.begin; i<batch.end; i++) {
+			const Item& item=items.at(i);
+			for(int j=0; j<elementSize(item.type); j++) {
+				GLuint v=elements[item.type].at(item.first+j);
+				quint64 key=cell>0.0?cellOf(v,whole.lower,cell):0;
+				QHash<quint64,int>::iterator it=owners.find(key);
+				if(it==owners.end())
+					owners.insert(key,b);
+				else if(it.value()!=b)
+					it.value()=-1;
+			}
+		}
+	}
+
+	for(int v=0; v<borders.size(); v++) {
+		quint64 key=cell>0.0?cellOf(v,whole.lower,cell):0;
+		borders[v]=owners.value(key,0)<0;
+	}
+	return borders;
+}
+
+/* The cells of each level are twice the size of those of the level
+ * before, the first level keeping every element. */
+static double cellSize(double diagonal,int level)
+{
+	return level>0?diagonal/(256>>level):0.0;
+}
+
+quint64 MeshRenderer::cellOf(GLuint v,const double* lower,double cell) const
+{
+	quint64 key=0;
+	for(int k=0; k<3; k++) {
+		quint64 i=(quint64)((vertices.at(v*3+k)-lower[k])/cell);
+		key=(key<<21)|(i&0x1fffff);
+	}
+	return key;
+}
+
+void MeshRenderer::addLevel(const QVector<Item>& items,Batch& batch,int level,const QVector<bool>& borders)
+{
+	int begin=batch.begin;
+	int end=batch.end;
+	double cell=cellSize(batch.diagonal,level);
+	if(level>0 && cell<=0.0) {
+		for(int t=0; t<ElementTypes; t++) {
+			batch.offsets[level][t]=batch.offsets[0][t];
+			batch.counts[level][t]=batch.counts[0][t];
+		}
+		return;
+	}
+
+	/* Each cell gets one vertex at the average of the vertices that
+	 * fall in it. Points and border vertices are kept as they are. */
+	QHash<quint64,int> cells;
+	if(level>0) {
+		QVector<double> sums;
+		for(int i=begin; i<end; i++) {
+			const Item& item=items.at(i);
+			if(item.type>=Points)
+				continue;
+			for(int j=0; j<elementSize(item.type); j++) {
+				GLuint v=elements[item.type].at(item.first+j);
+				if(borders.at(v))
+					continue;
+				quint64 key=cellOf(v,batch.lower,cell);
+				int slot=cells.value(key,-1);
+				if(slot<0) {
+					slot=sums.size()/7;
+					cells.insert(key,slot);
+					for(int k=0; k<7; k++)
+						sums.append(0.0);
+				}
+				for(int k=0; k<3; k++) {
+					sums[slot*7+k]+=vertices.at(v*3+k);
+					sums[slot*7+3+k]+=normals.at(v*3+k);
+				}
+				sums[slot*7+6]+=1.0;
+			}
+		}
+
+		QHash<quint64,int>::iterator it;
+		for(it=cells.begin(); it!=cells.end(); ++it) {
+			const double* s=sums.constData()+it.value()*7;
+			it.value()=appendVertex(s[0]/s[6],s[1]/s[6],s[2]/s[6],s[3],s[4],s[5]);
+		}
+	}
+
+	for(int t=0; t<ElementTypes; t++) {
+		batch.offsets[level][t]=indices.size();
+		for(int i=begin; i<end; i++) {
+			const Item& item=items.at(i);
+			if(item.type!=t)
+				continue;
+			int size=elementSize(item.type);
+			GLuint mapped[3];
+			for(int j=0; j<size; j++) {
+				GLuint v=elements[t].at(item.first+j);
+				bool merged=level>0 && t<Points && !borders.at(v);
+				mapped[j]=merged?cells.value(cellOf(v,batch.lower,cell)):v;
+			}
+			//Elements that collapse are left out
+			bool collapsed=false;
+			for(int j=0; j<size; j++)
+				for(int k=j+1; k<size; k++)
+					if(mapped[j]==mapped[k])
+						collapsed=true;
+			if(collapsed)
+				continue;
+			for(int j=0; j<size; j++)
+				indices.append(mapped[j]);
+		}
+		batch.counts[level][t]=indices.size()-batch.offsets[level][t];
+	}
+}
+
+bool MeshRenderer::outside(const double* planes,const double* lower,const double* upper) const
+{
+	for(int i=0; i<6; i++) {
+		const double* p=planes+i*4;
+		double x=p[0]>0?upper[0]:lower[0];
+		double y=p[1]>0?upper[1]:lower[1];
+		double z=p[2]>0?upper[2]:lower[2];
+		if(p[0]*x+p[1]*y+p[2]*z+p[3]<0)
+			return true;
+	}
+	return false;
+}
+
+/* Picks the coarsest level whose cells are no bigger than the
+ * tolerance at the nearest point of the batch. */
+int MeshRenderer::chooseLevel(const Batch& batch,const double* m,double scale) const
+{
+	double x=(batch.lower[0]+batch.upper[0])/2;
+	double y=(batch.lower[1]+batch.upper[1])/2;
+	double z=(batch.lower[2]+batch.upper[2])/2;
+	double w=m[3]*x+m[7]*y+m[11]*z+m[15]-batch.diagonal/2;
+	if(w<=0.0)
+		return 0;
+
+	double pixels=scale/w;
+	int level=0;
+	for(int l=1; l<Levels; l++)
+		if(cellSize(batch.diagonal,l)*pixels<=tolerance)
+			level=l;
+	return level;
+}
+
+/* Finds the batches inside the view frustum, the planes of which are
+ * taken from the combined projection and modelview matrix. */
+void MeshRenderer::cull(const double* m,double scale)
+{
+	visible.clear();
+	levels.clear();
+	if(hierarchy.isEmpty())
+		return;
+
+	double planes[24];
+	for(int i=0; i<3; i++) {
+		for(int k=0; k<4; k++) {
+			planes[i*8+k]=m[k*4+3]+m[k*4+i];
+			planes[i*8+4+k]=m[k*4+3]-m[k*4+i];
+		}
+	}
+
+	QVector<int> stack;
+	stack.append(0);
+	while(!stack.isEmpty()) {
+		const Bounds& b=hierarchy.at(stack.last());
+		stack.remove(stack.size()-1);
+		if(outside(planes,b.lower,b.upper))
+			continue;
+		if(b.batch>=0) {
+			visible.append(b.batch);
+			levels.append(chooseLevel(batches.at(b.batch),m,scale));
+		} else {
+			stack.append(b.left);
+			stack.append(b.right);
+		}
+	}
+}
+
+void MeshRenderer::drawElements(GLenum mode,Elements_e type,const QColor& c)
+{
+	glColor3ub(c.red(),c.green(),c.blue());
+	for(int i=0; i<visible.size(); i++) {
+		const Batch& b=batches.at(visible.at(i));
+		int level=levels.at(i);
+		int count=b.counts[level][type];
+		if(count==0)
+			continue;
+		int offset=b.offsets[level][type];
+		if(buffered)
+			glDrawElements(mode,count,GL_UNSIGNED_INT,reinterpret_cast<const GLvoid*>(offset*sizeof(GLuint)));
+		else
+			glDrawElements(mode,count,GL_UNSIGNED_INT,indices.constData()+offset);
+	}
+}
+
+void MeshRenderer::draw(bool skeleton,bool showedges)
+{
+	init();
+
+	GLdouble modelview[16],projection[16];
+	GLint viewport[4];
+	glGetDoublev(GL_MODELVIEW_MATRIX,modelview);
+	glGetDoublev(GL_PROJECTION_MATRIX,projection);
+	glGetIntegerv(GL_VIEWPORT,viewport);
+	double m[16];
+	for(int c=0; c<4; c++)
+		for(int r=0; r<4; r++)
+			m[c*4+r]=projection[r]*modelview[c*4]+projection[4+r]*modelview[c*4+1]+
+				projection[8+r]*modelview[c*4+2]+projection[12+r]*modelview[c*4+3];
+	cull(m,projection[5]*viewport[3]/2.0);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	if(buffered) {
+		vertexBuffer.bind();
+		glVertexPointer(3,GL_FLOAT,0,0);
+		normalBuffer.bind();
+		glNormalPointer(GL_FLOAT,0,0);
+		indexBuffer.bind();
+	} else {
+		glVertexPointer(3,GL_FLOAT,0,vertices.constData());
+		glNormalPointer(GL_FLOAT,0,normals.constData());
+	}
+
+	if(!skeleton) {
+		//Push the facets back a little so that the edges drawn over them show
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(1.0,1.0);
+		drawElements(GL_TRIANGLES,Facets,facetColor);
+		drawElements(GL_TRIANGLES,MarkedFacets,markedFacetColor);
+		glDisable(GL_POLYGON_OFFSET_FILL);
+	}
+	glDisableClientState(GL_NORMAL_ARRAY);
+
+	if(skeleton||showedges) {
+		glDisable(GL_LIGHTING);
+		glLineWidth(edgeSize);
+		drawElements(GL_LINES,Edges,edgeColor);
+		drawElements(GL_LINES,MarkedEdges,markedEdgeColor);
+		glPointSize(vertexSize);
+		drawElements(GL_POINTS,Points,vertexColor);
+		drawElements(GL_POINTS,MarkedPoints,markedVertexColor);
+		glEnable(GL_LIGHTING);
+	}
+
+	if(buffered) {
+		indexBuffer.release();
+		normalBuffer.release();
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
@@ -0,0 +1,132 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MESHRENDERER_H
+#define MESHRENDERER_H
+
+#include <QVector>
+#include <QColor>
+#include <QGLBuffer>
+#include "renderer.h"
+
+/**
+  Draws an indexed mesh of triangles, edges and points in the colours
+  from the preferences. The mesh is uploaded into buffer objects the
+  first time it is drawn and nothing is rebuilt after that. Where buffer
+  objects are not available it is drawn from client memory instead.
+
+  The elements are split into batches that are kept in a bounding volume
+  hierarchy, so batches outside of the view are not drawn. Each batch
+  also has coarser versions of itself, made by merging the vertices that
+  fall in the same cell of a grid, which are used when the cells would
+  be smaller than a pixel on screen. Vertices at a position that a batch
+  shares with another are never merged, so that neighbouring batches
+  still meet when they are drawn at different levels.
+*/
+class MeshRenderer : public Renderer
+{
+public:
+	MeshRenderer();
+	int appendVertex(double,double,double);
+	int appendVertex(double,double,double,double,double,double);
+	void appendTriangle(int,int,int,bool);
+	void appendEdge(int,int,bool);
+	void appendPoint(int,bool);
+	void draw(bool,bool);
+protected:
+	QColor markedVertexColor;
+	QColor vertexColor;
+	QColor markedEdgeColor;
+	QColor edgeColor;
+	QColor markedFacetColor;
+	QColor facetColor;
+	double vertexSize;
+	double edgeSize;
+private:
+	enum Elements_e {
+		Facets,
+		MarkedFacets,
+		Edges,
+		MarkedEdges,
+		Points,
+		MarkedPoints,
+		ElementTypes
+	};
+
+	enum { Levels=4 };
+
+	struct Item {
+		Elements_e type;
+		int first;
+		double centre[3];
+	};
+
+	struct Batch {
+		double lower[3];
+		double upper[3];
+		double diagonal;
+		int begin;
+		int end;
+		int offsets[Levels][ElementTypes];
+		int counts[Levels][ElementTypes];
+	};
+
+	struct CentreLess {
+		int axis;
+		bool operator()(const Item& a,const Item& b) const
+		{
+			return a.centre[axis]<b.centre[axis];
+		}
+	};
+
+	struct Bounds {
+		double lower[3];
+		double upper[3];
+		int left;
+		int right;
+		int batch;
+	};
+
+	static int elementSize(Elements_e);
+	void init();
+	int build(QVector<Item>&,int,int);
+	void addBatch(const QVector<Item>&,int,int,Batch&);
+	QVector<bool> findBorders(const QVector<Item>&) const;
+	void addLevel(const QVector<Item>&,Batch&,int,const QVector<bool>&);
+	quint64 cellOf(GLuint,const double*,double) const;
+	int chooseLevel(const Batch&,const double*,double) const;
+	void cull(const double*,double);
+	bool outside(const double*,const double*,const double*) const;
+	void drawElements(GLenum,Elements_e,const QColor&);
+	QVector<GLfloat> vertices;
+	QVector<GLfloat> normals;
+	QVector<GLuint> elements[ElementTypes];
+	QVector<GLuint> indices;
+	QVector<Batch> batches;
+	QVector<Bounds> hierarchy;
+	QVector<int> visible;
+	QVector<int> levels;
+	QGLBuffer vertexBuffer;
+	QGLBuffer normalBuffer;
+	QGLBuffer indexBuffer;
+	bool initialised;
+	bool buffered;
+};
+
+#endif // MESHRENDERER_H
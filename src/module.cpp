@@ -17,15 +17,18 @@
  */
 
 #include "module.h"
+#include "symboltable.h"
 #include "context.h"
 
 Module::Module()
 {
+	symbol=0;
 	scope=NULL;
 }
 
-Module::Module(const QString n) : name(n)
+Module::Module(const QString n)
 {
+	symbol=SymbolTable::getInstance()->intern(n);
 	scope=NULL;
 }
 
@@ -33,18 +36,24 @@ Module::~Module()
 {
 	for(int i=0; i<parameters.size(); i++)
 		delete parameters.at(i);
+	qDeleteAll(names);
 
 	delete scope;
 }
 
 QString Module::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Module::getSymbol() const
+{
+	return this->symbol;
 }
 
 void Module::setName(QString name)
 {
-	this->name = name;
+	this->symbol = SymbolTable::getInstance()->intern(name);
 }
 
 
@@ -85,8 +94,20 @@ void Module::addParameter(QString name)
 	parameters.append(p);
 }
 
+/**
+  Creates a name, other than those of the parameters, that the module
+  looks up in its arguments.
+*/
+Parameter* Module::addName(QString name)
+{
+	Parameter* p = new Parameter();
+	p->setName(name);
+	names.append(p);
+	return p;
+}
+
 Value *Module::getParameterArgument(Context* ctx, int index)
 {
 	Parameter* p = parameters.at(index);
-	return ctx->getArgument(index,p->getName());
+	return ctx->getArgument(index,p);
 }
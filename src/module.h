@@ -37,6 +37,7 @@ public:
 	Module(const QString);
 	~Module();
 	QString getName() const;
+	int getSymbol() const;
 	void setName(QString);
 	QList<Parameter*> getParameters() const;
 	void setParameters(QList<Parameter*>);
@@ -46,10 +47,12 @@ public:
 	virtual Node* evaluate(Context*);
 protected:
 	void addParameter(QString);
+	Parameter* addName(QString);
 	Value* getParameterArgument(Context*,int);
 private:
-	QString name;
+	int symbol;
 	QList<Parameter*> parameters;
+	QList<Parameter*> names;
 	Scope* scope;
 };
 
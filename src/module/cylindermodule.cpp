@@ -29,6 +29,10 @@ CylinderModule::CylinderModule() : PrimitiveModule("cylinder")
 	addParameter("height");
 	addParameter("radius");
 	addParameter("center");
+	radius1Name=addName("radius1");
+	radius2Name=addName("radius2");
+	diameterName=addName("diameter");
+	centerName=addName("center");
 }
 
 Node* CylinderModule::evaluate(Context* ctx)
@@ -38,8 +42,8 @@ Node* CylinderModule::evaluate(Context* ctx)
 	if(heightValue)
 		h=heightValue->getNumber();
 
-	NumberValue* r1Value = dynamic_cast<NumberValue*>(ctx->getArgument(1,"radius1"));
-	NumberValue* r2Value = dynamic_cast<NumberValue*>(ctx->getArgument(2,"radius2"));
+	NumberValue* r1Value = dynamic_cast<NumberValue*>(ctx->getArgument(1,radius1Name));
+	NumberValue* r2Value = dynamic_cast<NumberValue*>(ctx->getArgument(2,radius2Name));
 	BooleanValue* centerValue;
 
 	double r1=1.0,r2=1.0;
@@ -49,7 +53,7 @@ Node* CylinderModule::evaluate(Context* ctx)
 		if(rValue) {
 			r1=r2=rValue->getNumber();
 		} else {
-			NumberValue* dValue = dynamic_cast<NumberValue*>(ctx->getArgument(1,"diameter"));
+			NumberValue* dValue = dynamic_cast<NumberValue*>(ctx->getArgument(1,diameterName));
 			if(dValue)
 				r1=r2=(dValue->getNumber()/2.0);
 		}
@@ -60,7 +64,7 @@ Node* CylinderModule::evaluate(Context* ctx)
 			r2=r2Value->getNumber();
 		else
 			r2=r1;
-		centerValue = dynamic_cast<BooleanValue*>(ctx->getArgument(3,"center"));
+		centerValue = dynamic_cast<BooleanValue*>(ctx->getArgument(3,centerName));
 	}
 	bool center = false;
 	if(centerValue)
@@ -26,6 +26,11 @@ class CylinderModule : public PrimitiveModule
 public:
 	CylinderModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* radius1Name;
+	Parameter* radius2Name;
+	Parameter* diameterName;
+	Parameter* centerName;
 };
 
 #endif // CYLINDERMODULE_H
@@ -19,19 +19,21 @@
 #include "echomodule.h"
 #include "context.h"
 
-EchoModule::EchoModule(QTextStream& s) : Module("echo"), output(s)
+EchoModule::EchoModule() : Module("echo")
 {
 }
 
 Node* EchoModule::evaluate(Context* ctx)
 {
-	QList<Value*> args=ctx->getArguments();
-	for(int i=0; i<args.size(); i++) {
-		if(i>0)
-			output << " ";
-		Value* a=args.at(i);
-		output << a->getValueString();
-	}
+	QStringList text;
+	foreach(Value* a,ctx->getArguments())
+		text.append(a->getValueString());
+
+	DiagnosticSink* diagnostics=ctx->getDiagnostics();
+	if(diagnostics)
+		diagnostics->report(new Diagnostic(Diagnostic::Echo,QStringList(text.join(" "))));
+	else
+		ctx->getOutput() << text.join(" ");
 
 	return NULL;
 }
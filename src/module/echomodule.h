@@ -19,16 +19,13 @@
 #ifndef ECHOMODULE_H
 #define ECHOMODULE_H
 
-#include <QTextStream>
 #include "module.h"
 
 class EchoModule : public Module
 {
 public:
-	EchoModule(QTextStream&);
+	EchoModule();
 	Node* evaluate(Context*);
-private:
-	QTextStream& output;
 };
 
 #endif // ECHOMODULE_H
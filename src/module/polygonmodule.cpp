@@ -7,12 +7,14 @@ PolygonModule::PolygonModule() : Module("polygon")
 {
 	addParameter("points");
 	addParameter("lines");
+	linesName=addName("lines");
+	pathsName=addName("paths");
 }
 
 Node* PolygonModule::evaluate(Context* ctx)
 {
 	VectorValue* pointsVec=dynamic_cast<VectorValue*>(getParameterArgument(ctx,0));
-	VectorValue* linesVec=dynamic_cast<VectorValue*>(ctx->getArgumentDeprecated(1,"lines","paths"));
+	VectorValue* linesVec=dynamic_cast<VectorValue*>(ctx->getArgumentDeprecated(1,linesName,pathsName));
 
 	PrimitiveNode* p=new PrimitiveNode();
 
@@ -9,6 +9,9 @@ class PolygonModule : public Module
 public:
 	PolygonModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* linesName;
+	Parameter* pathsName;
 };
 
 #endif // POLYGONMODULE_H
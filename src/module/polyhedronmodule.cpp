@@ -19,6 +19,7 @@
 #include "polyhedronmodule.h"
 #include "context.h"
 #include "vectorvalue.h"
+#include "packedvectorvalue.h"
 #include "numbervalue.h"
 #include "node/primitivenode.h"
 
@@ -26,27 +27,43 @@ PolyhedronModule::PolyhedronModule() : PrimitiveModule("polyhedron")
 {
 	addParameter("points");
 	addParameter("surfaces");
+	surfacesName=addName("surfaces");
+	trianglesName=addName("triangles");
 }
 
 Node* PolyhedronModule::evaluate(Context* ctx)
 {
 	VectorValue* points=dynamic_cast<VectorValue*>(getParameterArgument(ctx,0));
-	VectorValue* surfaces=dynamic_cast<VectorValue*>(ctx->getArgumentDeprecated(1,"surfaces","triangles"));
+	VectorValue* surfaces=dynamic_cast<VectorValue*>(ctx->getArgumentDeprecated(1,surfacesName,trianglesName));
 
-	QList<Value*> children = points->getChildren();
+	QList<Point> vertices;
+	if(points->getType()==Value::PackedVector) {
+		PackedVectorValue* packed=static_cast<PackedVectorValue*>(points);
+		const QVector<double>& n=packed->getNumbers();
+		int c=packed->getColumns();
+		for(int i=0; c>0 && i+c<=n.size(); i+=c)
+			vertices.append(Point(n.at(i),c>1?n.at(i+1):0,c>2?n.at(i+2):0));
+	} else {
+		foreach(Value* child,points->getChildren()) {
+			VectorValue* point=dynamic_cast<VectorValue*>(child);
+			vertices.append(point->getPoint());
+		}
+	}
 
 	PrimitiveNode* p=new PrimitiveNode();
 	foreach(Value* s,surfaces->getChildren()) {
 		p->createPolygon();
 		VectorValue* surface=dynamic_cast<VectorValue*>(s);
-		foreach(Value* indexVal,surface->getChildren()) {
-			NumberValue* indexNum=dynamic_cast<NumberValue*>(indexVal);
-			double index = indexNum->getNumber();
-			VectorValue* point=dynamic_cast<VectorValue*>(children.at(index));
-			Point pt = point->getPoint();
-			p->appendVertex(pt);
+		if(surface->getType()==Value::PackedVector) {
+			foreach(double index,static_cast<PackedVectorValue*>(surface)->getNumbers())
+				p->appendVertex(vertices.at(index));
+		} else {
+			foreach(Value* indexVal,surface->getChildren()) {
+				NumberValue* indexNum=dynamic_cast<NumberValue*>(indexVal);
+				double index = indexNum->getNumber();
+				p->appendVertex(vertices.at(index));
+			}
 		}
-
 	}
 
 	return p;
@@ -26,6 +26,9 @@ class PolyhedronModule : public PrimitiveModule
 public:
 	PolyhedronModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* surfacesName;
+	Parameter* trianglesName;
 };
 
 #endif // POLYHEDRONMODULE_H
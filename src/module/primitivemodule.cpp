@@ -21,9 +21,14 @@
 #include "tau.h"
 #include "context.h"
 #include "numbervalue.h"
+#include "symboltable.h"
 
 PrimitiveModule::PrimitiveModule(const QString n) : Module(n)
 {
+	SymbolTable* s=SymbolTable::getInstance();
+	fnSymbol=s->intern("fn");
+	fsSymbol=s->intern("fs");
+	faSymbol=s->intern("fa");
 }
 
 void PrimitiveModule::getSpecialVariables(Context* ctx, double& fn, double& fs, double& fa)
@@ -31,13 +36,13 @@ void PrimitiveModule::getSpecialVariables(Context* ctx, double& fn, double& fs,
 	fn=0.0;
 	fs=1.0;
 	fa=12.0;
-	NumberValue* fnVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial("fn"));
+	NumberValue* fnVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial(fnSymbol));
 	if(fnVal)
 		fn=fnVal->getNumber();
-	NumberValue* fsVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial("fs"));
+	NumberValue* fsVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial(fsSymbol));
 	if(fsVal)
 		fs=fsVal->getNumber();
-	NumberValue* faVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial("fa"));
+	NumberValue* faVal=dynamic_cast<NumberValue*>(ctx->getArgumentSpecial(faSymbol));
 	if(faVal)
 		fa=faVal->getNumber();
 }
@@ -33,6 +33,9 @@ protected:
 	Polygon getPolygon(double,double,double,double);
 private:
 	void getSpecialVariables(Context*,double&,double&,double&);
+	int fnSymbol;
+	int fsSymbol;
+	int faSymbol;
 };
 
 #endif // PRIMITIVEMODULE_H
@@ -26,6 +26,8 @@ PrismModule::PrismModule() : PrimitiveModule("prism")
 	addParameter("height");
 	addParameter("sides");
 	addParameter("apothem");
+	radiusName=addName("radius");
+	centerName=addName("center");
 }
 
 Node* PrismModule::evaluate(Context* ctx)
@@ -46,14 +48,14 @@ Node* PrismModule::evaluate(Context* ctx)
 		a=apothemVal->getNumber();
 		r=a/cos(M_PI/n);
 	} else {
-		NumberValue* radiusVal = dynamic_cast<NumberValue*>(ctx->getArgument(2,"radius"));
+		NumberValue* radiusVal = dynamic_cast<NumberValue*>(ctx->getArgument(2,radiusName));
 		if(radiusVal) {
 			r=radiusVal->getNumber();
 			a=r*cos(M_PI/n);
 		}
 	}
 
-	Value* centerVal = ctx->getArgument(3,"center");
+	Value* centerVal = ctx->getArgument(3,centerName);
 	bool center=false;
 	if(centerVal)
 		center=centerVal->isTrue();
@@ -27,6 +27,9 @@ class PrismModule : public PrimitiveModule
 public:
 	PrismModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* radiusName;
+	Parameter* centerName;
 };
 
 #endif // PRISMMODULE_H
@@ -27,6 +27,7 @@ RotateModule::RotateModule() : Module("rotate")
 {
 	addParameter("angle");
 	addParameter("vector");
+	vectorName=addName("vector");
 }
 
 Node* RotateModule::evaluate(Context* ctx)
@@ -44,7 +45,7 @@ Node* RotateModule::evaluate(Context* ctx)
 			vec=vecValue->getPoint();
 		origin=false;
 	} else {
-		VectorValue* vecValue=dynamic_cast<VectorValue*>(ctx->getArgument(0,"vector"));
+		VectorValue* vecValue=dynamic_cast<VectorValue*>(ctx->getArgument(0,vectorName));
 		if(vecValue)
 			vec=vecValue->getPoint();
 		origin=true;
@@ -27,6 +27,8 @@ class RotateModule : public Module
 public:
 	RotateModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* vectorName;
 };
 
 #endif // ROTATEMODULE_H
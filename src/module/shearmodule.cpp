@@ -25,22 +25,25 @@ ShearModule::ShearModule() : Module("shear")
 	addParameter("x");
 	addParameter("y");
 	addParameter("z");
+	xName=addName("x");
+	yName=addName("y");
+	zName=addName("z");
 }
 
 Node* ShearModule::evaluate(Context* ctx)
 {
 	Point vecSx;
-	VectorValue* xVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,"x"));
+	VectorValue* xVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,xName));
 	if(xVal)
 		vecSx=xVal->getPoint();
 
 	Point vecSy;
-	VectorValue* yVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,"y"));
+	VectorValue* yVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,yName));
 	if(yVal)
 		vecSy=yVal->getPoint();
 
 	Point vecSz;
-	VectorValue* zVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,"z"));
+	VectorValue* zVal=dynamic_cast<VectorValue*>(ctx->getArgument(0,zName));
 	if(zVal)
 		vecSz=zVal->getPoint();
 
@@ -27,6 +27,10 @@ class ShearModule : public Module
 public:
 	ShearModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* xName;
+	Parameter* yName;
+	Parameter* zName;
 };
 
 #endif // SHEARMODULE_H
@@ -28,6 +28,7 @@ SphereModule::SphereModule() : PrimitiveModule("sphere")
 {
 	addParameter("radius");
 	addParameter("center");
+	diameterName=addName("diameter");
 }
 
 Node* SphereModule::evaluate(Context* ctx)
@@ -43,7 +44,7 @@ Node* SphereModule::evaluate(Context* ctx)
 	if(rValue) {
 		r=rValue->getNumber();
 	} else {
-		NumberValue* dValue = dynamic_cast<NumberValue*>(ctx->getArgument(0,"diameter"));
+		NumberValue* dValue = dynamic_cast<NumberValue*>(ctx->getArgument(0,diameterName));
 		if(dValue)
 			r=(dValue->getNumber()/2.0);
 	}
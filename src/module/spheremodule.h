@@ -27,6 +27,8 @@ class SphereModule : public PrimitiveModule
 public:
 	SphereModule();
 	Node* evaluate(Context*);
+private:
+	Parameter* diameterName;
 };
 
 #endif // SPHEREMODULE_H
@@ -20,22 +20,20 @@
 
 Node::Node()
 {
-	nodes.append(this);
+	registry=Registry<Node>::current();
+	registry->add(this);
 }
 
 Node::~Node()
 {
-	nodes.removeAll(this);
+	registry->remove(this);
 }
 
 void Node::cleanup()
 {
-	foreach(Node* n, nodes)
-		delete n;
+	Registry<Node>::current()->cleanup();
 }
 
-QList<Node*> Node::nodes;
-
 void Node::setChildren(QList<Node*> c)
 {
 	children = c;
@@ -21,6 +21,7 @@
 
 #include <QList>
 #include "visitablenode.h"
+#include "registry.h"
 
 class Node : public VisitableNode
 {
@@ -31,7 +32,7 @@ public:
 	void setChildren(QList<Node*>);
 	QList<Node*> getChildren() const;
 private:
-	static QList<Node*> nodes;
+	Registry<Node>* registry;
 	QList<Node*> children;
 };
 
@@ -0,0 +1,40 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INSTANCENODE_H
+#define INSTANCENODE_H
+
+#include <QList>
+#include "node.h"
+#include "transformationnode.h"
+
+/* The union of several transformations of one shared base node. The
+ * base is the only child, each transformation also has the base as
+ * its only child. */
+class InstanceNode : public Node
+{
+public:
+	InstanceNode();
+	void setTransformations(QList<TransformationNode*>);
+	QList<TransformationNode*> getTransformations() const;
+	void accept(NodeVisitor&);
+private:
+	QList<TransformationNode*> transformations;
+};
+
+#endif // INSTANCENODE_H
@@ -0,0 +1,316 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QSet>
+#include "nodededuplicator.h"
+
+NodeDeduplicator::NodeDeduplicator()
+{
+	duplicates=0;
+	instances=0;
+	seed=0;
+}
+
+Node* NodeDeduplicator::deduplicate(Node* n)
+{
+	Node* u=canonical(n);
+	references.clear();
+	countReferences(u);
+	return u;
+}
+
+int NodeDeduplicator::getDuplicateCount() const
+{
+	return duplicates;
+}
+
+int NodeDeduplicator::getInstanceCount() const
+{
+	return instances;
+}
+
+QHash<Node*,int> NodeDeduplicator::getReferences() const
+{
+	return references;
+}
+
+/**
+  A digest of the structure of each unique subtree, which unlike the
+  node itself stays the same from one evaluation to the next.
+*/
+QHash<Node*,QByteArray> NodeDeduplicator::getDigests() const
+{
+	return digests;
+}
+
+/* Geometry drawn from a different seed must not be found in the cache */
+void NodeDeduplicator::setSeed(quint64 s)
+{
+	seed=s;
+}
+
+Node* NodeDeduplicator::canonical(Node* n)
+{
+	if(replacements.contains(n))
+		return replacements.value(n);
+
+	QList<Node*> children;
+	foreach(Node* c, n->getChildren())
+		children.append(canonical(c));
+
+	//The order of the operands of a union and of the subtracted
+	//operands of a difference does not matter
+	if(dynamic_cast<UnionNode*>(n)) {
+		children=groupInstances(children);
+	} else if(dynamic_cast<DifferenceNode*>(n) && children.size()>2) {
+		Node* first=children.takeFirst();
+		children=groupInstances(children);
+		children.prepend(first);
+	}
+	n->setChildren(children);
+
+	/* The key is made up of the node type and its parameters followed
+	 * by the digests of its children, which are already unique. */
+	key=QString::number(seed,16);
+	key.append(' ');
+	n->accept(*this);
+	foreach(Node* c, children) {
+		key.append(' ');
+		key.append(QString::fromLatin1(digests.value(c)));
+	}
+
+	Node* u=unique.value(key);
+	if(u) {
+		duplicates++;
+	} else {
+		unique.insert(key,n);
+		digests.insert(n,QCryptographicHash::hash(key.toUtf8(),QCryptographicHash::Sha1).toHex());
+		u=n;
+	}
+	replacements.insert(n,u);
+	return u;
+}
+
+/* Transformations of the same base node are replaced by a single
+ * instance node so that the base is only evaluated once. The same
+ * transformation given twice is only placed once. */
+QList<Node*> NodeDeduplicator::groupInstances(QList<Node*> children)
+{
+	QHash<Node*,QList<TransformationNode*> > groups;
+	foreach(Node* c, children) {
+		TransformationNode* t=dynamic_cast<TransformationNode*>(c);
+		if(t && t->getChildren().size()==1) {
+			QList<TransformationNode*>& group=groups[t->getChildren().first()];
+			if(!group.contains(t))
+				group.append(t);
+		}
+	}
+
+	QSet<Node*> emitted;
+	QList<Node*> result;
+	foreach(Node* c, children) {
+		TransformationNode* t=dynamic_cast<TransformationNode*>(c);
+		if(!t || t->getChildren().size()!=1) {
+			result.append(c);
+			continue;
+		}
+
+		Node* base=t->getChildren().first();
+		QList<TransformationNode*> group=groups.value(base);
+		if(group.size()<2) {
+			result.append(c);
+		} else if(!emitted.contains(base)) {
+			emitted.insert(base);
+			InstanceNode* i=new InstanceNode();
+			QList<Node*> b;
+			b.append(base);
+			i->setChildren(b);
+			i->setTransformations(group);
+			result.append(canonical(i));
+			instances+=group.size();
+		}
+	}
+	return result;
+}
+
+void NodeDeduplicator::countReferences(Node* n)
+{
+	//Only follow the children of a node the first time it is reached
+	if(references[n]++>0)
+		return;
+
+	foreach(Node* c, n->getChildren())
+		countReferences(c);
+}
+
+void NodeDeduplicator::appendKey(double d)
+{
+	key.append(' ');
+	key.append(QString::number(d,'g',17));
+}
+
+void NodeDeduplicator::appendKey(Point p)
+{
+	double x,y,z;
+	p.getXYZ(x,y,z);
+	appendKey(x);
+	appendKey(y);
+	appendKey(z);
+}
+
+void NodeDeduplicator::appendKey(Polygon pg)
+{
+	key.append(" (");
+	foreach(Point p, pg)
+		appendKey(p);
+	key.append(" )");
+}
+
+void NodeDeduplicator::visit(PrimitiveNode* n)
+{
+	key.append("polyhedron");
+	foreach(Polygon pg, n->getPolygons())
+		appendKey(pg);
+}
+
+void NodeDeduplicator::visit(PolylineNode* n)
+{
+	key.append("polyline");
+	appendKey(n->getPoints());
+}
+
+void NodeDeduplicator::visit(UnionNode*)
+{
+	key.append("union");
+}
+
+void NodeDeduplicator::visit(DifferenceNode*)
+{
+	key.append("difference");
+}
+
+void NodeDeduplicator::visit(IntersectionNode*)
+{
+	key.append("intersection");
+}
+
+void NodeDeduplicator::visit(SymmetricDifferenceNode*)
+{
+	key.append("symmetric_difference");
+}
+
+void NodeDeduplicator::visit(MinkowskiNode*)
+{
+	key.append("minkowski");
+}
+
+void NodeDeduplicator::visit(GlideNode* n)
+{
+	key.append("glide");
+	appendKey(n->getClosed());
+}
+
+void NodeDeduplicator::visit(HullNode*)
+{
+	key.append("hull");
+}
+
+void NodeDeduplicator::visit(LinearExtrudeNode* n)
+{
+	key.append("linear_extrude");
+	appendKey(n->getHeight());
+}
+
+void NodeDeduplicator::visit(RotateExtrudeNode* n)
+{
+	key.append("rotate_extrude");
+	appendKey(n->getRadius());
+}
+
+void NodeDeduplicator::visit(BoundsNode*)
+{
+	key.append("bounds");
+}
+
+void NodeDeduplicator::visit(SubDivisionNode* n)
+{
+	key.append("subdiv");
+	appendKey(n->getLevel());
+}
+
+void NodeDeduplicator::visit(OffsetNode* n)
+{
+	key.append("offset");
+	appendKey(n->getAmount());
+}
+
+void NodeDeduplicator::visit(OutlineNode*)
+{
+	key.append("outline");
+}
+
+void NodeDeduplicator::visit(ImportNode* n)
+{
+	key.append("import ");
+	key.append(n->getImport());
+	//The file can change between evaluations
+	key.append(' ');
+	key.append(QString::number(QFileInfo(n->getImport()).lastModified().toTime_t()));
+}
+
+void NodeDeduplicator::visit(TransformationNode* n)
+{
+	key.append("multmatrix");
+	for(int i=0; i<16; i++)
+		appendKey(n->matrix[i]);
+}
+
+void NodeDeduplicator::visit(ResizeNode* n)
+{
+	key.append("resize");
+	appendKey(n->getSize());
+	appendKey(n->getAutoSize());
+}
+
+void NodeDeduplicator::visit(CenterNode*)
+{
+	key.append("center");
+}
+
+void NodeDeduplicator::visit(PointNode* n)
+{
+	key.append("point");
+	appendKey(n->getPoint());
+}
+
+void NodeDeduplicator::visit(SliceNode* n)
+{
+	key.append("slice");
+	appendKey(n->getHeight());
+}
+
+void NodeDeduplicator::visit(InstanceNode* n)
+{
+	key.append("instance");
+	foreach(TransformationNode* t, n->getTransformations())
+		for(int i=0; i<16; i++)
+			appendKey(t->matrix[i]);
+}
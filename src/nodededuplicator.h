@@ -0,0 +1,102 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NODEDEDUPLICATOR_H
+#define NODEDEDUPLICATOR_H
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include "nodevisitor.h"
+#include "node/primitivenode.h"
+#include "node/polylinenode.h"
+#include "node/unionnode.h"
+#include "node/differencenode.h"
+#include "node/intersectionnode.h"
+#include "node/symmetricdifferencenode.h"
+#include "node/minkowskinode.h"
+#include "node/glidenode.h"
+#include "node/transformationnode.h"
+#include "node/linearextrudenode.h"
+#include "node/rotateextrudenode.h"
+#include "node/hullnode.h"
+#include "node/boundsnode.h"
+#include "node/subdivisionnode.h"
+#include "node/offsetnode.h"
+#include "node/outlinenode.h"
+#include "node/importnode.h"
+#include "node/resizenode.h"
+#include "node/centernode.h"
+#include "node/pointnode.h"
+#include "node/slicenode.h"
+#include "node/instancenode.h"
+
+/* Turns a node tree into a graph in which structurally identical
+ * subtrees are represented by a single node. */
+class NodeDeduplicator : public NodeVisitor
+{
+public:
+	NodeDeduplicator();
+	Node* deduplicate(Node*);
+	int getDuplicateCount() const;
+	int getInstanceCount() const;
+	QHash<Node*,int> getReferences() const;
+	QHash<Node*,QByteArray> getDigests() const;
+	void setSeed(quint64);
+
+	void visit(PrimitiveNode*);
+	void visit(PolylineNode*);
+	void visit(UnionNode*);
+	void visit(DifferenceNode*);
+	void visit(IntersectionNode*);
+	void visit(SymmetricDifferenceNode*);
+	void visit(MinkowskiNode*);
+	void visit(GlideNode*);
+	void visit(HullNode*);
+	void visit(LinearExtrudeNode*);
+	void visit(RotateExtrudeNode*);
+	void visit(BoundsNode*);
+	void visit(SubDivisionNode*);
+	void visit(OffsetNode*);
+	void visit(OutlineNode*);
+	void visit(ImportNode*);
+	void visit(TransformationNode*);
+	void visit(ResizeNode*);
+	void visit(CenterNode*);
+	void visit(PointNode*);
+	void visit(SliceNode*);
+	void visit(InstanceNode*);
+private:
+	Node* canonical(Node*);
+	QList<Node*> groupInstances(QList<Node*>);
+	void countReferences(Node*);
+	void appendKey(double);
+	void appendKey(Point);
+	void appendKey(Polygon);
+
+	QString key;
+	QHash<QString,Node*> unique;
+	QHash<Node*,Node*> replacements;
+	QHash<Node*,int> references;
+	QHash<Node*,QByteArray> digests;
+	int duplicates;
+	int instances;
+	quint64 seed;
+};
+
+#endif // NODEDEDUPLICATOR_H
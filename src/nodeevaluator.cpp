@@ -27,6 +27,11 @@
 
 NodeEvaluator::NodeEvaluator(QTextStream& s) : output(s)
 {
+	geometry=NULL;
+	profile=NULL;
+	listener=NULL;
+	cancelled=NULL;
+	diagnostics=NULL;
 }
 
 NodeEvaluator::~NodeEvaluator()
@@ -34,6 +39,106 @@ NodeEvaluator::~NodeEvaluator()
 	Node::cleanup();
 }
 
+void NodeEvaluator::setReferences(QHash<Node*,int> r)
+{
+	references=r;
+}
+
+void NodeEvaluator::setDigests(QHash<Node*,QByteArray> d)
+{
+	digests=d;
+}
+
+/**
+  Subtrees found in the geometry cache are not evaluated, and the
+  results of those that are get added to it.
+*/
+void NodeEvaluator::setGeometryCache(GeometryCache* g)
+{
+	geometry=g;
+}
+
+void NodeEvaluator::setProfile(NodeProfile* p)
+{
+	profile=p;
+}
+
+void NodeEvaluator::setListener(RenderListener* l)
+{
+	listener=l;
+}
+
+/**
+  The evaluation is abandoned, by throwing a CancelledException, at the
+  next checkpoint after the given flag has been set. A CGAL operation
+  that is already running is always allowed to finish.
+*/
+void NodeEvaluator::setCancelled(const QAtomicInt* c)
+{
+	cancelled=c;
+}
+
+void NodeEvaluator::setDiagnostics(DiagnosticSink* d)
+{
+	diagnostics=d;
+}
+
+void NodeEvaluator::report(Diagnostic* d)
+{
+	if(diagnostics) {
+		diagnostics->report(d);
+		return;
+	}
+	output << d->getMessage() << "\n";
+	delete d;
+}
+
+void NodeEvaluator::checkCancelled()
+{
+	if(cancelled && *cancelled!=0)
+		throw CancelledException();
+}
+
+/* Nodes with more than one parent are evaluated once. Operations
+ * modify their operands in place so each parent gets its own copy of
+ * the result, apart from the last which gets the original. */
+void NodeEvaluator::evaluate(Node* n)
+{
+	checkCancelled();
+	int count=references.value(n);
+	if(!cache.contains(n)) {
+		if(profile)
+			profile->start(n);
+		QByteArray digest=geometry?digests.value(n):QByteArray();
+		Primitive* g=digest.isEmpty()?NULL:geometry->get(digest);
+		if(g) {
+			result=g;
+		} else {
+			n->accept(*this);
+			if(!digest.isEmpty())
+				geometry->insert(digest,result);
+		}
+		if(profile)
+			profile->finish(n,result,g!=NULL);
+		if(listener)
+			listener->finish(n,result);
+		if(count<2)
+			return;
+		cache.insert(n,result);
+	}
+
+	Primitive* p=cache.value(n);
+	count--;
+	if(count>0) {
+		references.insert(n,count);
+		result=p?p->copy():NULL;
+	} else {
+		references.remove(n);
+		cache.remove(n);
+		result=p;
+	}
+}
+
 void NodeEvaluator::visit(PrimitiveNode* n)
 {
 	Primitive* cp;
@@ -91,7 +196,7 @@ void NodeEvaluator::visit(GlideNode* op)
 {
 	Primitive* first=NULL;
 	foreach(Node* n, op->getChildren()) {
-		n->accept(*this);
+		evaluate(n);
 		if(!first) {
 #if USE_CGAL
 			CGALExplorer explorer(result);
@@ -109,6 +214,7 @@ void NodeEvaluator::visit(GlideNode* op)
 			first=new CGALPrimitive(pl);
 #endif
 		} else {
+			checkCancelled();
 			first=first->minkowski(result);
 		}
 	}
@@ -121,7 +227,7 @@ void NodeEvaluator::visit(HullNode* n)
 #if USE_CGAL
 	QList<CGAL::Point3> points;
 	foreach(Node* c,n->getChildren()) {
-		c->accept(*this);
+		evaluate(c);
 		CGALExplorer explorer(result);
 		points.append(explorer.getPoints());
 	}
@@ -201,11 +307,14 @@ void NodeEvaluator::visit(RotateExtrudeNode*)
 void NodeEvaluator::evaluate(Node* op,Operation_e type)
 {
 	Primitive* first=NULL;
+	int done=0;
 	foreach(Node* n, op->getChildren()) {
-		n->accept(*this);
+		evaluate(n);
+		done++;
 		if(!first) {
 			first=result;
 		} else {
+			checkCancelled();
 			switch(type) {
 			case Union:
 				first=first->join(result);
@@ -223,6 +332,8 @@ void NodeEvaluator::evaluate(Node* op,Operation_e type)
 				first=first->minkowski(result);
 				break;
 			}
+			if(listener)
+				listener->progress(op,first,done);
 		}
 	}
 
@@ -238,8 +349,8 @@ void NodeEvaluator::visit(BoundsNode* n)
 
 	//TODO move this warning into gcode generation routines when they exist.
 	if(b.zmin()!=0.0) {
-		QString where = b.zmin()<0.0?" below ":" above ";
-		output << "Warning: The model is " << b.zmin() << where << "the build platform.\n";
+		QString where = b.zmin()<0.0?"below":"above";
+		report(new Diagnostic(Diagnostic::BuildPlatform,QStringList() << QString::number(b.zmin()) << where));
 	}
 
 	output << "Bounds: ";
@@ -290,15 +401,22 @@ void NodeEvaluator::visit(ImportNode* op)
 #endif
 }
 
-void NodeEvaluator::visit(TransformationNode* tr)
-{
-	evaluate(tr,Union);
 #if USE_CGAL
+static CGAL::AffTransformation3 affine(TransformationNode* tr)
+{
 	double* m=tr->matrix;
-	CGAL::AffTransformation3 t(
+	return CGAL::AffTransformation3(
 		m[0], m[4], m[ 8], m[12],
 		m[1], m[5], m[ 9], m[13],
 		m[2], m[6], m[10], m[14], m[15]);
+}
+#endif
+
+void NodeEvaluator::visit(TransformationNode* tr)
+{
+	evaluate(tr,Union);
+#if USE_CGAL
+	CGAL::AffTransformation3 t=affine(tr);
 
 	CGALPrimitive* pr=dynamic_cast<CGALPrimitive*>(result);
 	if(pr)
@@ -414,3 +532,36 @@ Primitive* NodeEvaluator::getResult() const
 {
 	return result;
 }
+
+void NodeEvaluator::visit(InstanceNode* n)
+{
+	evaluate(n,Union);
+#if USE_CGAL
+	CGALPrimitive* base=dynamic_cast<CGALPrimitive*>(result);
+	if(!base)
+		return;
+
+	QList<TransformationNode*> transformations=n->getTransformations();
+	QList<Primitive*> parts;
+	for(int i=0; i<transformations.size(); i++) {
+		CGALPrimitive* p=base;
+		if(i<transformations.size()-1)
+			p=static_cast<CGALPrimitive*>(base->copy());
+		p->transform(affine(transformations.at(i)));
+		parts.append(p);
+	}
+
+	/* Join the instances pairwise rather than one at a time so that
+	 * each join works on operands of similar size. */
+	while(parts.size()>1) {
+		QList<Primitive*> joined;
+		for(int i=0; i+1<parts.size(); i+=2)
+			joined.append(parts.at(i)->join(parts.at(i+1)));
+		if(parts.size()%2)
+			joined.append(parts.last());
+		parts=joined;
+	}
+
+	result=parts.first();
+#endif
+}
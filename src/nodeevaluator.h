@@ -19,9 +19,15 @@
 #ifndef NODEEVALUATOR_H
 #define NODEEVALUATOR_H
 
+#include <QAtomicInt>
+#include <QHash>
 #include <QString>
 #include <QTextStream>
 #include "primitive.h"
+#include "geometrycache.h"
+#include "nodeprofile.h"
+#include "renderlistener.h"
+#include "diagnosticsink.h"
 #include "nodevisitor.h"
 #include "node/primitivenode.h"
 #include "node/polylinenode.h"
@@ -44,6 +50,12 @@
 #include "node/centernode.h"
 #include "node/pointnode.h"
 #include "node/slicenode.h"
+#include "node/instancenode.h"
+
+/* Thrown from the checkpoints of an evaluation that has been cancelled */
+class CancelledException
+{
+};
 
 class NodeEvaluator : public NodeVisitor
 {
@@ -80,11 +92,30 @@ public:
 	void visit(CenterNode*);
 	void visit(PointNode*);
 	void visit(SliceNode*);
+	void visit(InstanceNode*);
 
+	void evaluate(Node*);
 	void evaluate(Node*,Operation_e);
 	Primitive* getResult() const;
+	void setReferences(QHash<Node*,int>);
+	void setDigests(QHash<Node*,QByteArray>);
+	void setGeometryCache(GeometryCache*);
+	void setProfile(NodeProfile*);
+	void setCancelled(const QAtomicInt*);
+	void setListener(RenderListener*);
+	void setDiagnostics(DiagnosticSink*);
 private:
+	void checkCancelled();
+	void report(Diagnostic*);
 	Primitive* result;
+	QHash<Node*,int> references;
+	QHash<Node*,Primitive*> cache;
+	QHash<Node*,QByteArray> digests;
+	GeometryCache* geometry;
+	NodeProfile* profile;
+	RenderListener* listener;
+	const QAtomicInt* cancelled;
+	DiagnosticSink* diagnostics;
 	QTextStream& output;
 };
 
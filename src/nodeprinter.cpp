@@ -182,3 +182,11 @@ void NodePrinter::visit(TransformationNode* n)
 		c->accept(*this);
 	result << "}";
 }
+
+void NodePrinter::visit(InstanceNode* n)
+{
+	result << "union(){";
+	foreach(TransformationNode* t,n->getTransformations())
+		t->accept(*this);
+	result << "}";
+}
@@ -42,6 +42,7 @@
 #include "node/centernode.h"
 #include "node/pointnode.h"
 #include "node/slicenode.h"
+#include "node/instancenode.h"
 
 class NodePrinter : public NodeVisitor
 {
@@ -69,6 +70,7 @@ public:
 	void visit(CenterNode*);
 	void visit(PointNode*);
 	void visit(SliceNode*);
+	void visit(InstanceNode*);
 
 private:
 	QTextStream& result;
@@ -0,0 +1,357 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include "nodeprofile.h"
+
+#if USE_CGAL
+#include "cgalprimitive.h"
+#endif
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+NodeProfile::NodeProfile()
+{
+	clock.start();
+}
+
+void NodeProfile::startStage(QString n)
+{
+	Stage s;
+	s.name=n;
+	s.start=clock.nsecsElapsed();
+	s.time=0;
+	stages.append(s);
+}
+
+void NodeProfile::finishStage()
+{
+	if(stages.isEmpty())
+		return;
+	Stage& s=stages.last();
+	s.time=clock.nsecsElapsed()-s.start;
+}
+
+/* A node that is evaluated again keeps the entry from its first
+ * evaluation, which only counts how many times it was reused. */
+void NodeProfile::start(Node* n)
+{
+	if(entries.contains(n)) {
+		Entry& e=entries[n];
+		e.reuses++;
+		e.again=clock.nsecsElapsed();
+		running.append(n);
+		return;
+	}
+
+	name=QString();
+	n->accept(*this);
+
+	Entry e;
+	e.name=name;
+	e.start=clock.nsecsElapsed();
+	e.time=0;
+	e.children=0;
+	e.peak=0;
+	e.again=0;
+	e.reuses=0;
+	e.cached=false;
+	e.done=false;
+	e.input=getSize(NULL);
+	e.output=getSize(NULL);
+	entries.insert(n,e);
+	order.append(n);
+	running.append(n);
+}
+
+void NodeProfile::finish(Node* n,Primitive* result,bool cached)
+{
+	running.removeAll(n);
+	Entry& e=entries[n];
+	if(e.done) {
+		if(!running.isEmpty())
+			entries[running.last()].children+=clock.nsecsElapsed()-e.again;
+		return;
+	}
+	e.done=true;
+	e.time=clock.nsecsElapsed()-e.start;
+	e.output=getSize(result);
+	e.peak=getPeakMemory();
+	e.cached=cached;
+
+	//The input is what the children gave, which are finished by now
+	foreach(Node* c,n->getChildren()) {
+		if(!entries.contains(c))
+			continue;
+		Size s=entries.value(c).output;
+		e.input.vertices+=s.vertices;
+		e.input.facets+=s.facets;
+		e.input.volumes+=s.volumes;
+	}
+
+	if(!running.isEmpty())
+		entries[running.last()].children+=e.time;
+}
+
+NodeProfile::Size NodeProfile::getSize(Primitive* p)
+{
+	Size s;
+	s.vertices=0;
+	s.facets=0;
+	s.volumes=0;
+#if USE_CGAL
+	CGALPrimitive* cp=dynamic_cast<CGALPrimitive*>(p);
+	if(cp) {
+		const CGAL::NefPolyhedron3& nef=cp->getNefPolyhedron();
+		s.vertices=nef.number_of_vertices();
+		s.facets=nef.number_of_facets();
+		s.volumes=nef.number_of_volumes();
+	}
+#else
+	Q_UNUSED(p);
+#endif
+	return s;
+}
+
+/* The high water mark of the memory used by the whole process, which
+ * only rises where a node needed more than anything before it. */
+qint64 NodeProfile::getPeakMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS pmc;
+	if(GetProcessMemoryInfo(GetCurrentProcess(),&pmc,sizeof(pmc)))
+		return pmc.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF,&usage)!=0)
+		return 0;
+#if defined(Q_OS_MAC)
+	return usage.ru_maxrss;
+#else
+	return (qint64)usage.ru_maxrss*1024;
+#endif
+#endif
+}
+
+QString NodeProfile::formatTime(qint64 ns)
+{
+	return QString("%1ms").arg(ns/1000000.0,0,'f',1);
+}
+
+QString NodeProfile::formatSize(Size s)
+{
+	return QString("%1v %2f %3vol").arg(s.vertices).arg(s.facets).arg(s.volumes);
+}
+
+void NodeProfile::printStages(QTextStream& output)
+{
+	foreach(Stage s,stages)
+		output << QString("%1 time: %2.\n").arg(s.name).arg(formatTime(s.time));
+	output << QString("Peak memory: %1MB.\n").arg(getPeakMemory()/1048576);
+}
+
+void NodeProfile::printTree(QTextStream& output,Node* root)
+{
+	QSet<Node*> printed;
+	printTree(output,root,0,printed);
+}
+
+void NodeProfile::printTree(QTextStream& output,Node* n,int depth,QSet<Node*>& printed)
+{
+	output << QString(depth*2,' ');
+	if(!entries.contains(n)) {
+		name=QString();
+		n->accept(*this);
+		output << name << "\n";
+	} else {
+		Entry e=entries.value(n);
+		output << e.name << " " << formatTime(e.time);
+		if(e.children>0)
+			output << " (self " << formatTime(e.time-e.children) << ")";
+		output << " in " << formatSize(e.input);
+		output << " out " << formatSize(e.output);
+		output << " peak " << e.peak/1048576 << "MB";
+		if(e.cached)
+			output << " cached";
+		if(e.reuses>0)
+			output << " reused " << e.reuses;
+		if(printed.contains(n)) {
+			output << " shared\n";
+			return;
+		}
+		output << "\n";
+	}
+	printed.insert(n);
+
+	foreach(Node* c,n->getChildren())
+		printTree(output,c,depth+1,printed);
+}
+
+static QString escape(QString s)
+{
+	s.replace("\\","\\\\");
+	s.replace("\"","\\\"");
+	return s;
+}
+
+bool NodeProfile::writeTrace(QString filename)
+{
+	QFile file(filename);
+	if(!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+		return false;
+
+	QTextStream trace(&file);
+	trace << "{\"traceEvents\":[\n";
+	bool first=true;
+	foreach(Stage s,stages) {
+		if(!first)
+			trace << ",\n";
+		first=false;
+		trace << QString("{\"name\":\"%1\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":1,\"tid\":1}")
+			 .arg(escape(s.name)).arg(s.start/1000).arg(s.time/1000);
+	}
+	foreach(Node* n,order) {
+		Entry e=entries.value(n);
+		if(!first)
+			trace << ",\n";
+		first=false;
+		trace << QString("{\"name\":\"%1\",\"cat\":\"node\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":1,\"tid\":1,")
+			 .arg(escape(e.name)).arg(e.start/1000).arg(e.time/1000);
+		trace << QString("\"args\":{\"input\":\"%1\",\"output\":\"%2\",\"peak MB\":%3,\"cached\":%4,\"reuses\":%5}}")
+			 .arg(formatSize(e.input)).arg(formatSize(e.output)).arg(e.peak/1048576).arg(e.cached?"true":"false").arg(e.reuses);
+	}
+	trace << "\n]}\n";
+	trace.flush();
+	return true;
+}
+
+void NodeProfile::visit(PrimitiveNode*)
+{
+	name="polyhedron";
+}
+
+void NodeProfile::visit(PolylineNode*)
+{
+	name="polyline";
+}
+
+void NodeProfile::visit(UnionNode*)
+{
+	name="union";
+}
+
+void NodeProfile::visit(DifferenceNode*)
+{
+	name="difference";
+}
+
+void NodeProfile::visit(IntersectionNode*)
+{
+	name="intersection";
+}
+
+void NodeProfile::visit(SymmetricDifferenceNode*)
+{
+	name="symmetric_difference";
+}
+
+void NodeProfile::visit(MinkowskiNode*)
+{
+	name="minkowski";
+}
+
+void NodeProfile::visit(GlideNode*)
+{
+	name="glide";
+}
+
+void NodeProfile::visit(HullNode*)
+{
+	name="hull";
+}
+
+void NodeProfile::visit(LinearExtrudeNode*)
+{
+	name="linear_extrude";
+}
+
+void NodeProfile::visit(RotateExtrudeNode*)
+{
+	name="rotate_extrude";
+}
+
+void NodeProfile::visit(BoundsNode*)
+{
+	name="bounds";
+}
+
+void NodeProfile::visit(SubDivisionNode*)
+{
+	name="subdiv";
+}
+
+void NodeProfile::visit(OffsetNode*)
+{
+	name="offset";
+}
+
+void NodeProfile::visit(OutlineNode*)
+{
+	name="outline";
+}
+
+void NodeProfile::visit(ImportNode* n)
+{
+	name=QString("import \"%1\"").arg(n->getImport());
+}
+
+void NodeProfile::visit(TransformationNode*)
+{
+	name="multmatrix";
+}
+
+void NodeProfile::visit(ResizeNode*)
+{
+	name="resize";
+}
+
+void NodeProfile::visit(CenterNode*)
+{
+	name="center";
+}
+
+void NodeProfile::visit(PointNode*)
+{
+	name="point";
+}
+
+void NodeProfile::visit(SliceNode*)
+{
+	name="slice";
+}
+
+void NodeProfile::visit(InstanceNode* n)
+{
+	name=QString("instance[%1]").arg(n->getTransformations().size());
+}
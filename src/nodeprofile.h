@@ -0,0 +1,132 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NODEPROFILE_H
+#define NODEPROFILE_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include "nodevisitor.h"
+#include "primitive.h"
+#include "node/primitivenode.h"
+#include "node/polylinenode.h"
+#include "node/unionnode.h"
+#include "node/differencenode.h"
+#include "node/intersectionnode.h"
+#include "node/symmetricdifferencenode.h"
+#include "node/minkowskinode.h"
+#include "node/glidenode.h"
+#include "node/transformationnode.h"
+#include "node/linearextrudenode.h"
+#include "node/rotateextrudenode.h"
+#include "node/hullnode.h"
+#include "node/boundsnode.h"
+#include "node/subdivisionnode.h"
+#include "node/offsetnode.h"
+#include "node/outlinenode.h"
+#include "node/importnode.h"
+#include "node/resizenode.h"
+#include "node/centernode.h"
+#include "node/pointnode.h"
+#include "node/slicenode.h"
+#include "node/instancenode.h"
+
+/**
+  Records how long each stage of a render takes and, for every node
+  that is evaluated, its wall time, the size of the polyhedra going in
+  and coming out and the peak memory use of the process afterwards.
+  The result can be printed as an annotated node tree or written as a
+  trace for chrome://tracing.
+*/
+class NodeProfile : public NodeVisitor
+{
+public:
+	NodeProfile();
+	void startStage(QString);
+	void finishStage();
+	void start(Node*);
+	void finish(Node*,Primitive*,bool);
+	void printStages(QTextStream&);
+	void printTree(QTextStream&,Node*);
+	bool writeTrace(QString);
+
+	void visit(PrimitiveNode*);
+	void visit(PolylineNode*);
+	void visit(UnionNode*);
+	void visit(DifferenceNode*);
+	void visit(IntersectionNode*);
+	void visit(SymmetricDifferenceNode*);
+	void visit(MinkowskiNode*);
+	void visit(GlideNode*);
+	void visit(HullNode*);
+	void visit(LinearExtrudeNode*);
+	void visit(RotateExtrudeNode*);
+	void visit(BoundsNode*);
+	void visit(SubDivisionNode*);
+	void visit(OffsetNode*);
+	void visit(OutlineNode*);
+	void visit(ImportNode*);
+	void visit(TransformationNode*);
+	void visit(ResizeNode*);
+	void visit(CenterNode*);
+	void visit(PointNode*);
+	void visit(SliceNode*);
+	void visit(InstanceNode*);
+private:
+	struct Size {
+		int vertices;
+		int facets;
+		int volumes;
+	};
+	struct Entry {
+		QString name;
+		qint64 start;
+		qint64 time;
+		qint64 children;
+		qint64 peak;
+		qint64 again;
+		int reuses;
+		bool cached;
+		bool done;
+		Size input;
+		Size output;
+	};
+	struct Stage {
+		QString name;
+		qint64 start;
+		qint64 time;
+	};
+	static Size getSize(Primitive*);
+	static qint64 getPeakMemory();
+	static QString formatTime(qint64);
+	static QString formatSize(Size);
+	void printTree(QTextStream&,Node*,int,QSet<Node*>&);
+
+	QElapsedTimer clock;
+	QHash<Node*,Entry> entries;
+	QList<Node*> order;
+	QList<Node*> running;
+	QList<Stage> stages;
+	QString name;
+};
+
+#endif // NODEPROFILE_H
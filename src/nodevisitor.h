@@ -44,6 +44,7 @@ public:
 	virtual void visit(class CenterNode*)=0;
 	virtual void visit(class PointNode*)=0;
 	virtual void visit(class SliceNode*)=0;
+	virtual void visit(class InstanceNode*)=0;
 };
 
 #endif // NODEVISITOR_H
@@ -18,12 +18,14 @@
 
 #include "numbervalue.h"
 #include "vectorvalue.h"
+#include "packedvectorvalue.h"
 #include "booleanvalue.h"
 
 NumberValue::NumberValue(double value)
 {
 	this->number=value;
 	this->defined=true;
+	this->type=Number;
 }
 
 QString NumberValue::getValueString() const
@@ -31,6 +33,11 @@ QString NumberValue::getValueString() const
 	return QString().setNum(this->number,'g',16);
 }
 
+Value* NumberValue::copy()
+{
+	return new NumberValue(this->number);
+}
+
 bool NumberValue::isTrue() const
 {
 	return this->number!=0;
@@ -49,8 +56,8 @@ Value* NumberValue::operation(Expression::Operator_e e)
 
 Value* NumberValue::operation(Value& v, Expression::Operator_e e)
 {
-	NumberValue* num = dynamic_cast<NumberValue*>(&v);
-	if(num) {
+	if(v.getType()==Number) {
+		NumberValue* num = static_cast<NumberValue*>(&v);
 		if(isComparison(e)) {
 			bool result=basicOperation<bool,double>(this->number,e,num->number);
 			return new BooleanValue(result);
@@ -59,9 +66,17 @@ Value* NumberValue::operation(Value& v, Expression::Operator_e e)
 			return new NumberValue(result);
 		}
 	}
-	VectorValue* vec = dynamic_cast<VectorValue*>(&v);
-	if(vec) {
+	if(v.isVector()) {
+		VectorValue* vec = static_cast<VectorValue*>(&v);
 		if(e==Expression::Concatenate) {
+			if(vec->getType()==PackedVector) {
+				PackedVectorValue* pack=static_cast<PackedVectorValue*>(vec);
+				if(!pack->isMatrix()) {
+					QVector<double> r=pack->getNumbers();
+					r.prepend(this->number);
+					return new PackedVectorValue(r);
+				}
+			}
 			QList<Value*> r=vec->getChildren();
 			r.prepend(this);
 			return new VectorValue(r);
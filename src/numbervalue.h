@@ -26,6 +26,7 @@ class NumberValue : public Value
 public:
 	NumberValue(double);
 	QString getValueString() const;
+	Value* copy();
 	bool isTrue() const;
 	double getNumber() const;
 private:
@@ -0,0 +1,367 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packedvectorvalue.h"
+#include "numbervalue.h"
+#include "booleanvalue.h"
+#include "vectoriterator.h"
+
+PackedVectorValue::PackedVectorValue(QVector<double> numbers)
+{
+	this->numbers=numbers;
+	this->columns=0;
+	this->defined=true;
+	this->type=PackedVector;
+}
+
+PackedVectorValue::PackedVectorValue(QVector<double> numbers,int columns)
+{
+	this->numbers=numbers;
+	this->columns=columns;
+	this->defined=true;
+	this->type=PackedVector;
+}
+
+PackedVectorValue* PackedVectorValue::pack(QList<Value*> values)
+{
+	if(values.isEmpty())
+		return NULL;
+
+	Value* first=values.first();
+	if(first->getType()==Number) {
+		QVector<double> numbers;
+		numbers.reserve(values.size());
+		foreach(Value* v, values) {
+			if(v->getType()!=Number)
+				return NULL;
+			numbers.append(static_cast<NumberValue*>(v)->getNumber());
+		}
+		return new PackedVectorValue(numbers);
+	}
+
+	if(first->getType()==PackedVector) {
+		int columns=static_cast<PackedVectorValue*>(first)->numbers.size();
+		if(columns==0)
+			return NULL;
+		QVector<double> numbers;
+		numbers.reserve(values.size()*columns);
+		foreach(Value* v, values) {
+			if(v->getType()!=PackedVector)
+				return NULL;
+			PackedVectorValue* row=static_cast<PackedVectorValue*>(v);
+			if(row->isMatrix()||row->numbers.size()!=columns)
+				return NULL;
+			numbers+=row->numbers;
+		}
+		return new PackedVectorValue(numbers,columns);
+	}
+
+	return NULL;
+}
+
+QString PackedVectorValue::getValueString() const
+{
+	QString result;
+	result.append("[");
+	for(int i=0; i<numbers.size(); i++) {
+		if(columns>0 && i%columns==0) {
+			if(i>0)
+				result.append("],");
+			result.append("[");
+		} else if(i>0) {
+			result.append(",");
+		}
+		result.append(QString().setNum(numbers.at(i),'g',16));
+	}
+	if(columns>0 && numbers.size()>0)
+		result.append("]");
+	result.append("]");
+	return result;
+}
+
+Value* PackedVectorValue::copy()
+{
+	return new PackedVectorValue(this->numbers,this->columns);
+}
+
+bool PackedVectorValue::isTrue() const
+{
+	return this->numbers.size()>0;
+}
+
+Point PackedVectorValue::getPoint() const
+{
+	double x=0,y=0,z=0;
+	if(!isMatrix()) {
+		int s=numbers.size();
+		if(s>0)
+			x=numbers.at(0);
+		if(s>1)
+			y=numbers.at(1);
+		if(s>2)
+			z=numbers.at(2);
+	}
+	return Point(x,y,z);
+}
+
+Iterator<Value*>* PackedVectorValue::createIterator()
+{
+	return new VectorIterator(this->getChildren());
+}
+
+QList<Value*> PackedVectorValue::getChildren()
+{
+	QList<Value*> result;
+	if(isMatrix()) {
+		for(int i=0; i<numbers.size(); i+=columns)
+			result.append(new PackedVectorValue(numbers.mid(i,columns)));
+	} else {
+		foreach(double n, numbers)
+			result.append(new NumberValue(n));
+	}
+	return result;
+}
+
+int PackedVectorValue::size()
+{
+	return getRows();
+}
+
+Value* PackedVectorValue::getIndex(int i)
+{
+	if(i<0||i>=getRows())
+		return new Value();
+	if(isMatrix())
+		return new PackedVectorValue(numbers.mid(i*columns,columns));
+	return new NumberValue(numbers.at(i));
+}
+
+const QVector<double>& PackedVectorValue::getNumbers() const
+{
+	return this->numbers;
+}
+
+bool PackedVectorValue::isMatrix() const
+{
+	return this->columns>0;
+}
+
+int PackedVectorValue::getRows() const
+{
+	return isMatrix()?numbers.size()/columns:numbers.size();
+}
+
+int PackedVectorValue::getColumns() const
+{
+	return this->columns;
+}
+
+bool PackedVectorValue::isArithmetic(Expression::Operator_e e)
+{
+	switch(e) {
+	case Expression::Exponent:
+	case Expression::Multiply:
+	case Expression::Divide:
+	case Expression::Modulus:
+	case Expression::Add:
+	case Expression::Subtract:
+	case Expression::AddAssign:
+	case Expression::SubAssign:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool PackedVectorValue::sameShape(PackedVectorValue* other) const
+{
+	return this->columns==other->columns && this->numbers.size()==other->numbers.size();
+}
+
+QVector<double> PackedVectorValue::componentwise(const QVector<double>& a,Expression::Operator_e e,const QVector<double>& b)
+{
+	int n=qMin(a.size(),b.size());
+	QVector<double> result(n);
+	const double* l=a.constData();
+	const double* r=b.constData();
+	double* o=result.data();
+
+	/* Keep the switch outside of the loops so that the common cases
+	 * are simple loops over contiguous arrays the compiler can
+	 * vectorise. */
+	switch(e) {
+	case Expression::Add:
+	case Expression::AddAssign:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]+r[i];
+		break;
+	case Expression::Subtract:
+	case Expression::SubAssign:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]-r[i];
+		break;
+	case Expression::Multiply:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]*r[i];
+		break;
+	case Expression::Divide:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]/r[i];
+		break;
+	default:
+		for(int i=0; i<n; i++)
+			o[i]=basicOperation<double,double>(l[i],e,r[i]);
+		break;
+	}
+	return result;
+}
+
+QVector<double> PackedVectorValue::componentwise(const QVector<double>& a,Expression::Operator_e e,double r)
+{
+	int n=a.size();
+	QVector<double> result(n);
+	const double* l=a.constData();
+	double* o=result.data();
+
+	switch(e) {
+	case Expression::Add:
+	case Expression::AddAssign:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]+r;
+		break;
+	case Expression::Subtract:
+	case Expression::SubAssign:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]-r;
+		break;
+	case Expression::Multiply:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]*r;
+		break;
+	case Expression::Divide:
+		for(int i=0; i<n; i++)
+			o[i]=l[i]/r;
+		break;
+	default:
+		for(int i=0; i<n; i++)
+			o[i]=basicOperation<double,double>(l[i],e,r);
+		break;
+	}
+	return result;
+}
+
+Value* PackedVectorValue::multiply(PackedVectorValue* vec)
+{
+	const double* a=numbers.constData();
+	const double* b=vec->numbers.constData();
+
+	if(!isMatrix() && !vec->isMatrix()) {
+		//Dot product
+		int n=numbers.size();
+		if(n!=vec->numbers.size())
+			return new Value();
+		double dot=0;
+		for(int i=0; i<n; i++)
+			dot+=a[i]*b[i];
+		return new NumberValue(dot);
+	}
+
+	int rows=getRows();
+	int inner=isMatrix()?columns:1;
+	int cols=vec->isMatrix()?vec->columns:1;
+
+	if(!isMatrix()) {
+		//Row vector times matrix
+		rows=1;
+		inner=numbers.size();
+	}
+	if(vec->getRows()!=inner)
+		return new Value();
+
+	/* The loops are ordered so that the innermost loop walks
+	 * contiguous rows of both the right operand and the result. */
+	QVector<double> result(rows*cols,0.0);
+	double* o=result.data();
+	for(int i=0; i<rows; i++) {
+		double* r=o+i*cols;
+		for(int k=0; k<inner; k++) {
+			double s=a[i*inner+k];
+			const double* c=b+k*cols;
+			for(int j=0; j<cols; j++)
+				r[j]+=s*c[j];
+		}
+	}
+
+	if(isMatrix() && vec->isMatrix())
+		return new PackedVectorValue(result,cols);
+	return new PackedVectorValue(result);
+}
+
+Value* PackedVectorValue::operation(Expression::Operator_e e)
+{
+	if(e==Expression::Invert)
+		return VectorValue::operation(e);
+
+	QVector<double> result(numbers.size());
+	for(int i=0; i<numbers.size(); i++)
+		result[i]=basicOperation<double,double>(numbers.at(i),e);
+	return new PackedVectorValue(result,columns);
+}
+
+Value* PackedVectorValue::operation(Value& v, Expression::Operator_e e)
+{
+	if(v.getType()==PackedVector) {
+		PackedVectorValue* vec=static_cast<PackedVectorValue*>(&v);
+		if(e==Expression::Concatenate && !isMatrix() && !vec->isMatrix()) {
+			return new PackedVectorValue(numbers+vec->numbers);
+		}
+		if(e==Expression::Equal||e==Expression::NotEqual) {
+			bool eq=sameShape(vec) && numbers==vec->numbers;
+			return new BooleanValue(e==Expression::Equal?eq:!eq);
+		}
+		if(e==Expression::Multiply) {
+			return multiply(vec);
+		}
+		if(e==Expression::ComponentwiseMultiply||e==Expression::ComponentwiseDivide||
+				e==Expression::Divide||e==Expression::Add||e==Expression::Subtract||
+				e==Expression::AddAssign||e==Expression::SubAssign||
+				e==Expression::Exponent||e==Expression::Modulus) {
+			/* Plain vectors of differing lengths are truncated to the
+			 * shorter length, matrices must match exactly. */
+			if(isMatrix()==vec->isMatrix() && (!isMatrix()||sameShape(vec))) {
+				e=convertOperation(e);
+				return new PackedVectorValue(componentwise(numbers,e,vec->numbers),columns);
+			}
+		}
+	} else if(v.getType()==Number) {
+		double num=static_cast<NumberValue*>(&v)->getNumber();
+		if(e==Expression::Concatenate) {
+			if(!isMatrix()) {
+				QVector<double> result=numbers;
+				result.append(num);
+				return new PackedVectorValue(result);
+			}
+		} else {
+			e=convertOperation(e);
+			if(isArithmetic(e))
+				return new PackedVectorValue(componentwise(numbers,e,num),columns);
+		}
+	}
+
+	return VectorValue::operation(v,e);
+}
@@ -0,0 +1,58 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKEDVECTORVALUE_H
+#define PACKEDVECTORVALUE_H
+
+#include <QVector>
+#include "vectorvalue.h"
+
+/* A vector of numbers, or a matrix of equal length rows of numbers,
+ * held as a flat array of doubles rather than a list of values. */
+class PackedVectorValue : public VectorValue
+{
+public:
+	PackedVectorValue(QVector<double>);
+	PackedVectorValue(QVector<double>,int);
+	static PackedVectorValue* pack(QList<Value*>);
+	QString getValueString() const;
+	Value* copy();
+	bool isTrue() const;
+	Point getPoint() const;
+	Iterator<Value*>* createIterator();
+	QList<Value*> getChildren();
+	int size();
+	Value* getIndex(int);
+	const QVector<double>& getNumbers() const;
+	bool isMatrix() const;
+	int getRows() const;
+	int getColumns() const;
+protected:
+	Value* operation(Expression::Operator_e);
+	Value* operation(Value&,Expression::Operator_e);
+private:
+	bool isArithmetic(Expression::Operator_e);
+	bool sameShape(PackedVectorValue*) const;
+	Value* multiply(PackedVectorValue*);
+	QVector<double> componentwise(const QVector<double>&,Expression::Operator_e,const QVector<double>&);
+	QVector<double> componentwise(const QVector<double>&,Expression::Operator_e,double);
+	QVector<double> numbers;
+	int columns;
+};
+
+#endif // PACKEDVECTORVALUE_H
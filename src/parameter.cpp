@@ -17,9 +17,12 @@
  */
 
 #include "parameter.h"
+#include "symboltable.h"
 
 Parameter::Parameter()
 {
+	symbol=0;
+	abbreviation=0;
 	expression=NULL;
 }
 
@@ -30,12 +33,35 @@ Parameter::~Parameter()
 
 QString Parameter::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Parameter::getSymbol() const
+{
+	return this->symbol;
+}
+
+/**
+  The symbol of the shortest name that builtins also accept for the
+  parameter. That is its first letter, or its first and last letters
+  when the name ends in a digit.
+*/
+int Parameter::getAbbreviation() const
+{
+	return this->abbreviation;
 }
 
 void Parameter::setName(QString name)
 {
-	this->name = name;
+	SymbolTable* s=SymbolTable::getInstance();
+	this->symbol = s->intern(name);
+
+	//TODO make the abbreviation work for names ending with any digit
+	this->abbreviation=0;
+	if(name.endsWith('1') || name.endsWith('2'))
+		this->abbreviation = s->intern(name.left(1)+name.right(1));
+	else if(!name.isEmpty())
+		this->abbreviation = s->intern(name.left(1));
 }
 
 Expression* Parameter::getExpression() const
@@ -28,12 +28,15 @@ public:
 	Parameter();
 	~Parameter();
 	QString getName() const;
+	int getSymbol() const;
+	int getAbbreviation() const;
 	void setName(QString);
 	Expression* getExpression() const;
 	void setExpression(Expression*);
 	void accept(TreeVisitor&);
 private:
-	QString name;
+	int symbol;
+	int abbreviation;
 	Expression* expression;
 };
 
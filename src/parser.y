@@ -18,26 +18,36 @@
 
 %expect 1 // Dangling else problem causes 1 shift/reduce conflict
 
+%code requires {
+class AbstractSyntaxTreeBuilder;
+class TokenBuilder;
+class Reporter;
+}
+
 %{
 #include <QString>
 #include <QList>
+#include <QFileInfo>
 #include "syntaxtreebuilder.h"
 #include "tokenbuilder.h"
 #include "script.h"
 #include "reporter.h"
 
-extern char *lexertext;
-extern void lexerinit(AbstractTokenBuilder*,Reporter*,QString,bool);
-extern void lexerdestroy();
 Script* parse(QString,Reporter*);
+Script* parse(QString,Reporter*,bool);
+void parse(QString,Reporter*,AbstractSyntaxTreeBuilder*);
+void parse(QString,Reporter*,AbstractSyntaxTreeBuilder*,bool);
 
-static void parsererror(char const *);
-static int parserlex();
-static AbstractSyntaxTreeBuilder *builder;
-static AbstractTokenBuilder* tokenizer;
-static Reporter* reporter;
+static void parsererror(AbstractSyntaxTreeBuilder*,TokenBuilder*,Reporter*,char const *);
+static int parserlex(union YYSTYPE*,TokenBuilder*);
 %}
 
+%define api.pure
+%parse-param { AbstractSyntaxTreeBuilder* builder }
+%parse-param { TokenBuilder* tokenizer }
+%parse-param { Reporter* reporter }
+%lex-param { TokenBuilder* tokenizer }
+
 %union {
 	QString* text;
 	double number;
@@ -57,10 +67,12 @@ static Reporter* reporter;
 	class Variable* var;
 	class Invocation* inv;
 	class QList<class CodeDoc*>* cdocs;
+	class Script* script;
 }
 %token DOCSTART DOCEND
 %token <text> DOCPARAM
 %token <text> DOCTEXT
+%token <script> INCLUDE
 %token <text> USE
 %token <text> IMPORT
 %token MODULE FUNCTION
@@ -152,6 +164,10 @@ single_declaration_list
 	{ $$ = builder->buildDeclarations($1); }
 	| single_declaration_list single_declaration
 	{ $$ = builder->buildDeclarations($1,$2); }
+	| INCLUDE
+	{ $$ = builder->buildInclude($1); }
+	| single_declaration_list INCLUDE
+	{ $$ = builder->buildInclude($1,$2); }
 	;
 
 declaration_list
@@ -446,29 +462,45 @@ argument
 
 %%
 
-static int parserlex()
+static int parserlex(YYSTYPE* value,TokenBuilder* tokenizer)
 {
-	return tokenizer->nextToken();
+	return tokenizer->nextToken(value);
 }
 
-static void parsererror(char const *s)
+static void parsererror(AbstractSyntaxTreeBuilder*,TokenBuilder* tokenizer,Reporter* reporter,char const *s)
 {
-	reporter->reportSyntaxError(tokenizer,s,lexertext);
+	reporter->reportSyntaxError(tokenizer,s,tokenizer->getText());
 }
 
-Script* parse(QString path, Reporter* r)
+void parse(QString input, Reporter* reporter, AbstractSyntaxTreeBuilder* builder, bool file)
 {
-	reporter=r;
-	builder=new SyntaxTreeBuilder();
-
-	tokenizer=new TokenBuilder();
-	lexerinit(tokenizer,reporter,path,true);
-	parserparse();
-	lexerdestroy();
+	TokenBuilder* tokenizer=new TokenBuilder(reporter,input,file);
+	builder->setTokenizer(tokenizer);
+	parserparse(builder,tokenizer,reporter);
+	builder->buildIncludes(tokenizer->getIncludes());
+	builder->setTokenizer(NULL);
 	delete tokenizer;
+}
+
+void parse(QString path, Reporter* reporter, AbstractSyntaxTreeBuilder* builder)
+{
+	parse(path,reporter,builder,true);
+}
+
+Script* parse(QString input, Reporter* reporter, bool file)
+{
+	AbstractSyntaxTreeBuilder* builder=new SyntaxTreeBuilder();
+	parse(input,reporter,builder,file);
 
 	Script* s=builder->getResult();
+	if(file)
+		s->setFileName(QFileInfo(input).absoluteFilePath());
 	delete builder;
 
 	return s;
 }
+
+Script* parse(QString path, Reporter* reporter)
+{
+	return parse(path,reporter,true);
+}
@@ -0,0 +1,294 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "previewbuilder.h"
+
+#if USE_CGAL
+#include "cgalexplorer.h"
+#include "cgalprimitive.h"
+#endif
+
+//Milliseconds between updates while rendering
+static const int interval=500;
+
+PreviewBuilder::PreviewBuilder(Node* n,QObject* parent) : QObject(parent)
+{
+	root=n;
+	renderer=NULL;
+	subtract=false;
+}
+
+PreviewBuilder::~PreviewBuilder()
+{
+	qDeleteAll(finishedResults);
+	qDeleteAll(partialResults);
+}
+
+/* Builds a preview from what is known so far and hands it out, the
+ * receiver takes ownership of the renderer. */
+void PreviewBuilder::update()
+{
+	renderer=new PreviewRenderer();
+	for(int i=0; i<16; i++)
+		matrix[i]=(i%5==0)?1.0:0.0;
+	subtract=false;
+	captureResults();
+	draw(root);
+	emit updated(renderer);
+	renderer=NULL;
+	timer.start();
+}
+
+bool PreviewBuilder::due() const
+{
+	return !timer.isValid() || timer.elapsed()>=interval;
+}
+
+/* Every result is kept, only the updates are held back until they are
+ * due. Results are copied since the operations that follow modify their
+ * operands, but only captured once an update draws them. */
+void PreviewBuilder::finish(Node* n,Primitive* p)
+{
+	if(!p)
+		return;
+	keep(finishedResults,n,p);
+	delete partialResults.take(n);
+	partial.remove(n);
+	done.remove(n);
+	if(due())
+		update();
+}
+
+/* The result of an operation on the first few of its children */
+void PreviewBuilder::progress(Node* n,Primitive* p,int count)
+{
+	if(!p)
+		return;
+	keep(partialResults,n,p);
+	done.insert(n,count);
+	if(due())
+		update();
+}
+
+void PreviewBuilder::keep(QHash<Node*,Primitive*>& results,Node* n,Primitive* p)
+{
+	delete results.take(n);
+	results.insert(n,p->copy());
+}
+
+void PreviewBuilder::captureResults()
+{
+	foreach(Node* n,finishedResults.keys()) {
+		Primitive* p=finishedResults.take(n);
+		finished.insert(n,capture(p));
+		delete p;
+	}
+	foreach(Node* n,partialResults.keys()) {
+		Primitive* p=partialResults.take(n);
+		partial.insert(n,capture(p));
+		delete p;
+	}
+}
+
+QList<Polygon> PreviewBuilder::capture(Primitive* p)
+{
+	QList<Polygon> polygons;
+#if USE_CGAL
+	CGALExplorer explorer(p);
+	CGALPrimitive* prim=explorer.getPrimitive();
+	foreach(CGALPolygon* pg,prim->getPolygons()) {
+		Polygon polygon;
+		foreach(CGAL::Point3 pt,pg->getPoints())
+			polygon.append(Point(to_double(pt.x()),to_double(pt.y()),to_double(pt.z())));
+		polygons.append(polygon);
+	}
+	delete prim;
+#endif
+	return polygons;
+}
+
+void PreviewBuilder::draw(Node* n)
+{
+	if(finished.contains(n))
+		append(finished.value(n));
+	else
+		n->accept(*this);
+}
+
+void PreviewBuilder::drawChildren(Node* n)
+{
+	int first=0;
+	if(partial.contains(n)) {
+		append(partial.value(n));
+		first=done.value(n);
+	}
+	QList<Node*> children=n->getChildren();
+	for(int i=first; i<children.size(); i++)
+		draw(children.at(i));
+}
+
+void PreviewBuilder::append(const QList<Polygon>& polygons)
+{
+	const double* m=matrix;
+	foreach(Polygon pg,polygons) {
+		Polygon transformed;
+		foreach(Point pt,pg) {
+			double x,y,z;
+			pt.getXYZ(x,y,z);
+			double w=m[3]*x+m[7]*y+m[11]*z+m[15];
+			transformed.append(Point(
+				(m[0]*x+m[4]*y+m[8]*z+m[12])/w,
+				(m[1]*x+m[5]*y+m[9]*z+m[13])/w,
+				(m[2]*x+m[6]*y+m[10]*z+m[14])/w));
+		}
+		renderer->appendPolygon(transformed,subtract);
+	}
+}
+
+void PreviewBuilder::visit(PrimitiveNode* n)
+{
+	append(n->getPolygons());
+}
+
+void PreviewBuilder::visit(PolylineNode*)
+{
+}
+
+void PreviewBuilder::visit(UnionNode* n)
+{
+	drawChildren(n);
+}
+
+/* Everything but the first child is subtracted */
+void PreviewBuilder::visit(DifferenceNode* n)
+{
+	int first=0;
+	if(partial.contains(n)) {
+		append(partial.value(n));
+		first=done.value(n);
+	}
+	bool s=subtract;
+	QList<Node*> children=n->getChildren();
+	for(int i=first; i<children.size(); i++) {
+		subtract=s||i>0;
+		draw(children.at(i));
+	}
+	subtract=s;
+}
+
+void PreviewBuilder::visit(IntersectionNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(SymmetricDifferenceNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(MinkowskiNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(GlideNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(HullNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(LinearExtrudeNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(RotateExtrudeNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(BoundsNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(SubDivisionNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(OffsetNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(OutlineNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(ImportNode*)
+{
+}
+
+void PreviewBuilder::visit(TransformationNode* tr)
+{
+	double saved[16];
+	for(int i=0; i<16; i++)
+		saved[i]=matrix[i];
+
+	const double* m=tr->matrix;
+	for(int c=0; c<4; c++)
+		for(int r=0; r<4; r++)
+			matrix[c*4+r]=saved[r]*m[c*4]+saved[4+r]*m[c*4+1]+saved[8+r]*m[c*4+2]+saved[12+r]*m[c*4+3];
+
+	drawChildren(tr);
+
+	for(int i=0; i<16; i++)
+		matrix[i]=saved[i];
+}
+
+void PreviewBuilder::visit(ResizeNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(CenterNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(PointNode*)
+{
+}
+
+void PreviewBuilder::visit(SliceNode* n)
+{
+	drawChildren(n);
+}
+
+void PreviewBuilder::visit(InstanceNode* n)
+{
+	foreach(TransformationNode* tr,n->getTransformations())
+		draw(tr);
+}
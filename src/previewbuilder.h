@@ -0,0 +1,116 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PREVIEWBUILDER_H
+#define PREVIEWBUILDER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include "nodevisitor.h"
+#include "primitive.h"
+#include "renderer.h"
+#include "previewrenderer.h"
+#include "renderlistener.h"
+#include "node/primitivenode.h"
+#include "node/polylinenode.h"
+#include "node/unionnode.h"
+#include "node/differencenode.h"
+#include "node/intersectionnode.h"
+#include "node/symmetricdifferencenode.h"
+#include "node/minkowskinode.h"
+#include "node/glidenode.h"
+#include "node/transformationnode.h"
+#include "node/linearextrudenode.h"
+#include "node/rotateextrudenode.h"
+#include "node/hullnode.h"
+#include "node/boundsnode.h"
+#include "node/subdivisionnode.h"
+#include "node/offsetnode.h"
+#include "node/outlinenode.h"
+#include "node/importnode.h"
+#include "node/resizenode.h"
+#include "node/centernode.h"
+#include "node/pointnode.h"
+#include "node/slicenode.h"
+#include "node/instancenode.h"
+
+/**
+  Builds quick previews of a node tree while it is being rendered. At
+  first the preview is just the primitives at the leaves of the tree,
+  the parts that get subtracted being drawn translucent. As the render
+  goes on the subtrees that have been finished, and the operations that
+  are partly done, are drawn from their results instead.
+*/
+class PreviewBuilder : public QObject, public NodeVisitor, public RenderListener
+{
+	Q_OBJECT
+public:
+	PreviewBuilder(Node*,QObject* parent=0);
+	~PreviewBuilder();
+	void update();
+	void finish(Node*,Primitive*);
+	void progress(Node*,Primitive*,int);
+
+	void visit(PrimitiveNode*);
+	void visit(PolylineNode*);
+	void visit(UnionNode*);
+	void visit(DifferenceNode*);
+	void visit(IntersectionNode*);
+	void visit(SymmetricDifferenceNode*);
+	void visit(MinkowskiNode*);
+	void visit(GlideNode*);
+	void visit(HullNode*);
+	void visit(LinearExtrudeNode*);
+	void visit(RotateExtrudeNode*);
+	void visit(BoundsNode*);
+	void visit(SubDivisionNode*);
+	void visit(OffsetNode*);
+	void visit(OutlineNode*);
+	void visit(ImportNode*);
+	void visit(TransformationNode*);
+	void visit(ResizeNode*);
+	void visit(CenterNode*);
+	void visit(PointNode*);
+	void visit(SliceNode*);
+	void visit(InstanceNode*);
+signals:
+	void updated(Renderer*);
+private:
+	bool due() const;
+	QList<Polygon> capture(Primitive*);
+	void keep(QHash<Node*,Primitive*>&,Node*,Primitive*);
+	void captureResults();
+	void draw(Node*);
+	void drawChildren(Node*);
+	void append(const QList<Polygon>&);
+	Node* root;
+	QHash<Node*,QList<Polygon> > finished;
+	QHash<Node*,QList<Polygon> > partial;
+	QHash<Node*,int> done;
+	QHash<Node*,Primitive*> finishedResults;
+	QHash<Node*,Primitive*> partialResults;
+	QElapsedTimer timer;
+	PreviewRenderer* renderer;
+	double matrix[16];
+	bool subtract;
+};
+
+#endif // PREVIEWBUILDER_H
@@ -0,0 +1,109 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QGLWidget>
+#include "previewrenderer.h"
+#include "preferences.h"
+
+PreviewRenderer::PreviewRenderer()
+{
+	initialised=false;
+}
+
+void PreviewRenderer::appendPolygon(const Polygon& pg,bool subtract)
+{
+	if(subtract)
+		subtracted.append(pg);
+	else
+		polygons.append(pg);
+}
+
+/* The preview is built on the worker thread, so the preferences are
+ * only read once it gets drawn. */
+void PreviewRenderer::init()
+{
+	if(initialised)
+		return;
+	Preferences* p=Preferences::getInstance();
+	facetColor=p->getFacetColor();
+	subtractedColor=p->getMarkedFacetColor();
+	subtractedColor.setAlpha(80);
+	edgeColor=p->getEdgeColor();
+	initialised=true;
+}
+
+void PreviewRenderer::draw(bool skeleton,bool showedges)
+{
+	init();
+	if(!skeleton) {
+		glColor4ub(facetColor.red(),facetColor.green(),facetColor.blue(),facetColor.alpha());
+		drawFacets(polygons);
+
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+		glDepthMask(GL_FALSE);
+		glColor4ub(subtractedColor.red(),subtractedColor.green(),subtractedColor.blue(),subtractedColor.alpha());
+		drawFacets(subtracted);
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+	}
+	if(skeleton||showedges) {
+		glDisable(GL_LIGHTING);
+		glColor3ub(edgeColor.red(),edgeColor.green(),edgeColor.blue());
+		drawEdges(polygons);
+		glEnable(GL_LIGHTING);
+	}
+}
+
+void PreviewRenderer::drawFacets(const QList<Polygon>& pgs)
+{
+	foreach(Polygon pg,pgs) {
+		//Newell's method copes with polygons that are not quite planar
+		double nx=0,ny=0,nz=0;
+		for(int i=0; i<pg.size(); i++) {
+			double x1,y1,z1,x2,y2,z2;
+			pg.at(i).getXYZ(x1,y1,z1);
+			pg.at((i+1)%pg.size()).getXYZ(x2,y2,z2);
+			nx+=(y1-y2)*(z1+z2);
+			ny+=(z1-z2)*(x1+x2);
+			nz+=(x1-x2)*(y1+y2);
+		}
+		glBegin(GL_POLYGON);
+		glNormal3d(nx,ny,nz);
+		foreach(Point pt,pg) {
+			double x,y,z;
+			pt.getXYZ(x,y,z);
+			glVertex3d(x,y,z);
+		}
+		glEnd();
+	}
+}
+
+void PreviewRenderer::drawEdges(const QList<Polygon>& pgs)
+{
+	foreach(Polygon pg,pgs) {
+		glBegin(GL_LINE_LOOP);
+		foreach(Point pt,pg) {
+			double x,y,z;
+			pt.getXYZ(x,y,z);
+			glVertex3d(x,y,z);
+		}
+		glEnd();
+	}
+}
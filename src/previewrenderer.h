@@ -0,0 +1,50 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PREVIEWRENDERER_H
+#define PREVIEWRENDERER_H
+
+#include <QList>
+#include <QColor>
+#include "renderer.h"
+#include "polygon.h"
+
+/**
+  Draws plain polygons, used to show something while the exact result
+  is still being rendered. Subtracted polygons are drawn translucent.
+*/
+class PreviewRenderer : public Renderer
+{
+public:
+	PreviewRenderer();
+	void appendPolygon(const Polygon&,bool);
+	void draw(bool,bool);
+private:
+	void init();
+	void drawFacets(const QList<Polygon>&);
+	void drawEdges(const QList<Polygon>&);
+	QList<Polygon> polygons;
+	QList<Polygon> subtracted;
+	bool initialised;
+	QColor facetColor;
+	QColor subtractedColor;
+	QColor edgeColor;
+};
+
+#endif // PREVIEWRENDERER_H
@@ -37,6 +37,7 @@ public:
 	virtual Primitive* minkowski(const Primitive*)=0;
 	virtual Primitive* inset(double)=0;
 	virtual bool isFullyDimentional()=0;
+	virtual Primitive* copy()=0;
 };
 
 #endif // PRIMITIVE_H
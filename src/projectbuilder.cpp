@@ -0,0 +1,242 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QProcess>
+#include <QThread>
+#include <QSet>
+#include <QCryptographicHash>
+#include "projectbuilder.h"
+#include "dependencybuilder.h"
+
+extern void parse(QString,Reporter*,AbstractSyntaxTreeBuilder*);
+
+ProjectBuilder::ProjectBuilder(QTextStream& s) : output(s)
+{
+	reporter=new Reporter(output);
+	executable="rapcad";
+}
+
+ProjectBuilder::~ProjectBuilder()
+{
+	delete reporter;
+}
+
+void ProjectBuilder::setExecutable(QString e)
+{
+	executable=e;
+}
+
+QList<QString> ProjectBuilder::getDependencies(QString path)
+{
+	if(dependencies.contains(path))
+		return dependencies.value(path);
+
+	QList<QString> result;
+	if(QFileInfo(path).exists()) {
+		DependencyBuilder builder;
+		parse(path,reporter,&builder);
+		foreach(QString dep,builder.getDependencies())
+			result.append(QFileInfo(dep).absoluteFilePath());
+	}
+	dependencies.insert(path,result);
+	return result;
+}
+
+/**
+  The source itself followed by everything it depends on,
+  directly or indirectly.
+*/
+QList<QString> ProjectBuilder::getInputs(QString path)
+{
+	QList<QString> inputs;
+	QSet<QString> visited;
+	QList<QString> pending;
+	pending.append(path);
+	while(!pending.isEmpty()) {
+		QString p=pending.takeFirst();
+		if(visited.contains(p))
+			continue;
+		visited.insert(p);
+		inputs.append(p);
+		pending.append(getDependencies(p));
+	}
+	return inputs;
+}
+
+QByteArray ProjectBuilder::getHash(QString path)
+{
+	if(hashes.contains(path))
+		return hashes.value(path);
+
+	QByteArray result;
+	QFile file(path);
+	if(file.open(QIODevice::ReadOnly))
+		result=QCryptographicHash::hash(file.readAll(),QCryptographicHash::Sha1).toHex();
+
+	hashes.insert(path,result);
+	return result;
+}
+
+QByteArray ProjectBuilder::getInputsHash(QString path)
+{
+	QList<QString> inputs=getInputs(path);
+	qSort(inputs);
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	foreach(QString input,inputs) {
+		hash.addData(input.toUtf8());
+		hash.addData(getHash(input));
+	}
+	return hash.result().toHex();
+}
+
+QString ProjectBuilder::getOutput(QString path)
+{
+	QFileInfo info(path);
+	return info.dir().filePath(info.completeBaseName()+".stl");
+}
+
+void ProjectBuilder::readHashes(QString filename)
+{
+	QFile file(filename);
+	if(!file.open(QIODevice::ReadOnly))
+		return;
+
+	QTextStream in(&file);
+	while(!in.atEnd()) {
+		QString line=in.readLine();
+		int space=line.indexOf(' ');
+		if(space>0)
+			built.insert(line.mid(space+1),line.left(space).toLatin1());
+	}
+}
+
+void ProjectBuilder::writeHashes(QString filename)
+{
+	QFile file(filename);
+	if(!file.open(QIODevice::WriteOnly))
+		return;
+
+	QTextStream out(&file);
+	foreach(QString source,built.keys())
+		out << built.value(source) << " " << source << "\n";
+}
+
+void ProjectBuilder::build(QString filename)
+{
+	QFileInfo info(filename);
+	Project project;
+	project.parseProject(info.absoluteFilePath());
+
+	QList<QString> sources;
+	foreach(QString source,project.getSources())
+		sources.append(QFileInfo(info.dir(),source).absoluteFilePath());
+
+	//Sources that other sources depend on are libraries, not outputs.
+	QSet<QString> libraries;
+	foreach(QString source,sources)
+		foreach(QString dep,getInputs(source))
+			if(dep!=source)
+				libraries.insert(dep);
+
+	QString hashFile=info.absoluteFilePath()+".sha1";
+	readHashes(hashFile);
+
+	QList<QString> stale;
+	QHash<QString,QByteArray> current;
+	foreach(QString source,sources) {
+		if(libraries.contains(source))
+			continue;
+
+		QByteArray hash=getInputsHash(source);
+		current.insert(source,hash);
+		if(built.value(source)!=hash || !QFileInfo(getOutput(source)).exists())
+			stale.append(source);
+		else
+			output << "Up to date: " << source << "\n";
+	}
+	output.flush();
+
+	QList<QString> rendered=render(stale);
+
+	foreach(QString source,stale)
+		if(rendered.contains(source))
+			built.insert(source,current.value(source));
+		else
+			built.remove(source);
+
+	writeHashes(hashFile);
+}
+
+/**
+  Each output is rendered by a separate process so that independent
+  outputs are built in parallel, up to one per processor. Returns the
+  sources whose process exited normally and successfully.
+*/
+QList<QString> ProjectBuilder::render(QList<QString> sources)
+{
+	int jobs=qMax(1,QThread::idealThreadCount());
+	QList<QProcess*> running;
+	QHash<QProcess*,QString> names;
+	QList<QString> rendered;
+
+	while(!sources.isEmpty() || !running.isEmpty()) {
+		while(!sources.isEmpty() && running.size()<jobs) {
+			QString source=sources.takeFirst();
+			QString out=getOutput(source);
+			QFile::remove(out);
+
+			QProcess* p=new QProcess();
+			p->setProcessChannelMode(QProcess::MergedChannels);
+			QStringList args;
+			args << "-o" << out << source;
+			p->start(executable,args);
+			if(!p->waitForStarted()) {
+				output << "Failed: " << source << " could not start " << executable << "\n";
+				output.flush();
+				delete p;
+				continue;
+			}
+			running.append(p);
+			names.insert(p,source);
+		}
+
+		foreach(QProcess* p,running) {
+			if(p->state()!=QProcess::NotRunning && !p->waitForFinished(100))
+				continue;
+
+			QString source=names.value(p);
+			if(p->exitStatus()==QProcess::NormalExit && p->exitCode()==0) {
+				output << "Built: " << source << "\n";
+				rendered.append(source);
+			} else if(p->exitStatus()==QProcess::NormalExit) {
+				output << "Failed: " << source << " exited with code " << p->exitCode() << "\n";
+			} else {
+				output << "Failed: " << source << " crashed\n";
+			}
+			output << p->readAllStandardOutput();
+			output.flush();
+			running.removeAll(p);
+			delete p;
+		}
+	}
+	return rendered;
+}
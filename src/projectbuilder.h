@@ -0,0 +1,62 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROJECTBUILDER_H
+#define PROJECTBUILDER_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QTextStream>
+#include "project.h"
+#include "reporter.h"
+
+/**
+  Renders the outputs of a project, skipping those whose inputs have
+  not changed since the last build. The inputs of an output are found
+  by following the include, use and import statements of its source.
+  The hashes of the inputs used by the last build are kept in a file
+  next to the project.
+*/
+class ProjectBuilder
+{
+public:
+	ProjectBuilder(QTextStream&);
+	~ProjectBuilder();
+	void setExecutable(QString);
+	void build(QString);
+private:
+	QList<QString> getDependencies(QString);
+	QList<QString> getInputs(QString);
+	QByteArray getHash(QString);
+	QByteArray getInputsHash(QString);
+	QString getOutput(QString);
+	void readHashes(QString);
+	void writeHashes(QString);
+	QList<QString> render(QList<QString>);
+
+	QTextStream& output;
+	Reporter* reporter;
+	QString executable;
+	QHash<QString,QList<QString> > dependencies;
+	QHash<QString,QByteArray> hashes;
+	QHash<QString,QByteArray> built;
+};
+
+#endif // PROJECTBUILDER_H
@@ -0,0 +1,69 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "random.h"
+
+Random::Random(quint64 s)
+{
+	seed=s;
+	counter=0;
+}
+
+quint64 Random::getSeed() const
+{
+	return seed;
+}
+
+/* Hands out the seed for the next independent generator, so that a
+ * whole tree of generators follows from the one seed. */
+quint64 Random::split()
+{
+	return derive(seed,counter++);
+}
+
+quint64 Random::derive(quint64 s,quint64 n)
+{
+	return mix(s+(n+1)*0x9e3779b97f4a7c15ULL);
+}
+
+/* SplitMix64 finalizer */
+quint64 Random::mix(quint64 z)
+{
+	z=(z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+	z=(z^(z>>27))*0x94d049bb133111ebULL;
+	return z^(z>>31);
+}
+
+double Random::toDouble(quint64 x)
+{
+	return (x>>11)*(1.0/9007199254740992.0);
+}
+
+QVector<double> Random::fill(int count, double min, double max)
+{
+	if(min>max)
+		qSwap(min,max);
+	double range=max-min;
+	QVector<double> numbers(count);
+	double* data=numbers.data();
+	quint64 base=seed+counter*0x9e3779b97f4a7c15ULL;
+	for(int i=0; i<count; ++i)
+		data[i]=toDouble(mix(base+(i+1)*0x9e3779b97f4a7c15ULL))*range+min;
+	counter+=count;
+	return numbers;
+}
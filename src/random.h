@@ -0,0 +1,45 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+  A counter based random number generator. The n-th number drawn is a
+  pure function of the seed and n, so a sequence never depends on any
+  shared state or on which thread asks for it.
+*/
+class Random
+{
+public:
+	Random(quint64);
+	quint64 getSeed() const;
+	quint64 split();
+	static quint64 derive(quint64,quint64);
+	static quint64 mix(quint64);
+	QVector<double> fill(int,double,double);
+private:
+	static double toDouble(quint64);
+	quint64 seed;
+	quint64 counter;
+};
+
+#endif // RANDOM_H
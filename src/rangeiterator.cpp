@@ -21,6 +21,11 @@
 RangeIterator::RangeIterator(RangeValue* rng)
 {
 	range=rng;
+	defaultStep=NULL;
+	step=NULL;
+	reverse=false;
+	if(range->isNumeric())
+		return;
 
 	Value& s=*range->getStart();
 	Value& f=*range->getFinish();
@@ -33,8 +38,6 @@ RangeIterator::RangeIterator(RangeValue* rng)
 		double i=reverse?-1.0:1.0;
 		defaultStep=new NumberValue(i);
 		step=defaultStep;
-	} else {
-		defaultStep=NULL;
 	}
 }
 
@@ -46,11 +49,19 @@ RangeIterator::~RangeIterator()
 void RangeIterator::first()
 {
 	index=range->getStart();
+	position=0;
 	done=false;
 }
 
 void RangeIterator::next()
 {
+	if(range->isNumeric()) {
+		position++;
+		if(position<range->size())
+			index=new NumberValue(range->numberAt(position));
+		return;
+	}
+
 	Value& i=*index;
 	Value& s=*step;
 	Value* r=i+s;
@@ -62,6 +73,9 @@ void RangeIterator::next()
 
 bool RangeIterator::isDone()
 {
+	if(range->isNumeric())
+		return position>=range->size();
+
 	if(done)
 		return true;
 
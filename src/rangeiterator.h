@@ -40,6 +40,7 @@ private:
 	NumberValue* defaultStep;
 	bool reverse;
 	bool done;
+	int position;
 };
 
 #endif // RANGEITERATOR_H
@@ -19,6 +19,9 @@
 #include "rangevalue.h"
 #include "rangeiterator.h"
 #include "vectorvalue.h"
+#include "numbervalue.h"
+#include <math.h>
+#include <limits.h>
 
 RangeValue::RangeValue(Value* start,Value* step, Value* finish)
 {
@@ -26,6 +29,53 @@ RangeValue::RangeValue(Value* start,Value* step, Value* finish)
 	this->step=step;
 	this->finish=finish;
 	this->defined=true;
+	this->type=Range;
+
+	/* When the bounds are plain numbers the range is described by its
+	 * first value, increment and count so that it can be iterated,
+	 * indexed and measured without expanding it. */
+	this->numeric=start->getType()==Number && finish->getType()==Number &&
+			(!step || step->getType()==Number);
+	this->lower=0;
+	this->increment=0;
+	this->count=0;
+	this->limited=false;
+	if(this->numeric) {
+		double s=static_cast<NumberValue*>(start)->getNumber();
+		double f=static_cast<NumberValue*>(finish)->getNumber();
+		bool reverse=s>f;
+		double i=reverse?-1.0:1.0;
+		if(step)
+			i=static_cast<NumberValue*>(step)->getNumber();
+
+		this->lower=s;
+		this->increment=i;
+		if(i==0 || (reverse?i>0:i<0)) {
+			//A step of zero or in the wrong direction only yields the start
+			this->count=1;
+		} else {
+			double n=floor((f-s)/i)+1;
+			if(n!=n) {
+				//Not a number, e.g. when the bounds are infinite
+				this->limited=true;
+			} else if(n>=INT_MAX) {
+				this->count=INT_MAX;
+				this->limited=true;
+			} else if(n>0) {
+				this->count=n;
+			}
+		}
+	}
+}
+
+/**
+  True when the range has more values than can be counted, in which case
+  only the first INT_MAX of them, or none if the size is not a number,
+  are iterated.
+*/
+bool RangeValue::isLimited() const
+{
+	return this->limited;
 }
 
 QString RangeValue::getValueString() const
@@ -42,6 +92,11 @@ QString RangeValue::getValueString() const
 	return result;
 }
 
+Value* RangeValue::copy()
+{
+	return new RangeValue(this->start,this->step,this->finish);
+}
+
 Iterator<Value*>* RangeValue::createIterator()
 {
 	return new RangeIterator(this);
@@ -50,13 +105,39 @@ Iterator<Value*>* RangeValue::createIterator()
 QList<Value*> RangeValue::getChildren()
 {
 	QList<Value*> result;
+	if(this->numeric) {
+		for(int i=0; i<count; i++)
+			result.append(new NumberValue(numberAt(i)));
+		return result;
+	}
+
 	Iterator<Value*>* i=this->createIterator();
 	for(i->first(); !i->isDone(); i->next())
 		result.append(i->currentItem());
+	delete i;
 
 	return result;
 }
 
+int RangeValue::size()
+{
+	if(this->numeric)
+		return this->count;
+
+	return VectorValue::size();
+}
+
+Value* RangeValue::getIndex(int i)
+{
+	if(this->numeric) {
+		if(i<0||i>=count)
+			return new Value();
+		return new NumberValue(numberAt(i));
+	}
+
+	return VectorValue::getIndex(i);
+}
+
 Value* RangeValue::getStart() const
 {
 	return this->start;
@@ -71,3 +152,13 @@ Value* RangeValue::getFinish() const
 {
 	return this->finish;
 }
+
+bool RangeValue::isNumeric() const
+{
+	return this->numeric;
+}
+
+double RangeValue::numberAt(int i) const
+{
+	return this->lower+i*this->increment;
+}
@@ -26,16 +26,27 @@ class RangeValue : public VectorValue
 public:
 	RangeValue(Value*,Value*,Value*);
 	QString getValueString() const;
+	Value* copy();
 	Iterator<Value*>* createIterator();
 	QList<Value*> getChildren();
+	int size();
+	Value* getIndex(int);
 
 	Value* getStart() const;
 	Value* getStep() const;
 	Value* getFinish() const;
+	bool isNumeric() const;
+	bool isLimited() const;
+	double numberAt(int) const;
 private:
 	Value* start;
 	Value* step;
 	Value* finish;
+	bool numeric;
+	double lower;
+	double increment;
+	int count;
+	bool limited;
 };
 
 #endif // RANGEVALUE_H
@@ -0,0 +1,103 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <QList>
+#include <QMutex>
+#include <QThreadStorage>
+
+/* A registry owns every object of type T created while it is attached
+ * to the creating thread. Each thread uses the process wide registry
+ * unless another one has been attached, so that independent evaluations
+ * can run side by side and clean up only what they created. */
+template <class T>
+class Registry
+{
+public:
+	Registry() {}
+	~Registry() { cleanup(); }
+
+	void add(T* t)
+	{
+		QMutexLocker locker(&lock);
+		items.append(t);
+	}
+
+	void remove(T* t)
+	{
+		QMutexLocker locker(&lock);
+		items.removeAll(t);
+	}
+
+	void cleanup()
+	{
+		/* Detach the list first so that each destructor does not
+		 * have to search it, otherwise cleanup is quadratic. */
+		lock.lock();
+		QList<T*> all=items;
+		items.clear();
+		lock.unlock();
+		foreach(T* t, all)
+			delete t;
+	}
+
+	static Registry<T>* current()
+	{
+		Handle* h=handles.localData();
+		return h?h->registry:global();
+	}
+
+	/* Attach r to the calling thread and return the registry that was
+	 * attached before, so that the caller can restore it when done. */
+	static Registry<T>* attach(Registry<T>* r)
+	{
+		Handle* h=handles.localData();
+		if(!h) {
+			h=new Handle();
+			h->registry=global();
+			handles.setLocalData(h);
+		}
+		Registry<T>* previous=h->registry;
+		h->registry=r;
+		return previous;
+	}
+private:
+	Registry(const Registry&);
+	Registry& operator=(const Registry&);
+	struct Handle {
+		Registry<T>* registry;
+	};
+	QList<T*> items;
+	QMutex lock;
+	static QThreadStorage<Handle*> handles;
+
+	/* The process wide registry is never destroyed, so whatever it
+	 * still holds at exit is left alone just as before. */
+	static Registry<T>* global()
+	{
+		static Registry<T>* g=new Registry<T>();
+		return g;
+	}
+};
+
+template <class T>
+QThreadStorage<typename Registry<T>::Handle*> Registry<T>::handles;
+
+#endif // REGISTRY_H
@@ -0,0 +1,37 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDERLISTENER_H
+#define RENDERLISTENER_H
+
+#include "node.h"
+#include "primitive.h"
+
+/**
+  Told about the results of a render as they become available, so that
+  the evaluator itself does not depend on how they are shown.
+*/
+class RenderListener
+{
+public:
+	virtual ~RenderListener() {}
+	virtual void finish(Node*,Primitive*)=0;
+	virtual void progress(Node*,Primitive*,int)=0;
+};
+
+#endif // RENDERLISTENER_H
@@ -0,0 +1,343 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QTime>
+#include <QSet>
+#include <QCoreApplication>
+#include <QtConcurrentRun>
+#include "renderserver.h"
+#include "batchrunner.h"
+#include "batchworker.h"
+#include "dependencybuilder.h"
+#include "reporter.h"
+
+extern void parse(QString,Reporter*,AbstractSyntaxTreeBuilder*);
+
+RenderServer::RenderServer(QTextStream& s,QObject* parent) :
+	QObject(parent),
+	output(s),
+	geometry(4096)
+{
+	outputTemplate="%d/%b.stl";
+	renderTime=0;
+
+	watcher=new QFileSystemWatcher(this);
+	connect(watcher,SIGNAL(directoryChanged(QString)),this,SLOT(directoryChanged(QString)));
+	connect(watcher,SIGNAL(fileChanged(QString)),this,SLOT(fileChanged(QString)));
+
+	server=new QLocalServer(this);
+	connect(server,SIGNAL(newConnection()),this,SLOT(newConnection()));
+
+	//Editors often write a file in several steps so wait for them to settle
+	timer=new QTimer(this);
+	timer->setSingleShot(true);
+	timer->setInterval(200);
+	connect(timer,SIGNAL(timeout()),this,SLOT(renderNext()));
+
+	rendering=new QFutureWatcher<bool>(this);
+	connect(rendering,SIGNAL(finished()),this,SLOT(renderDone()));
+}
+
+RenderServer::~RenderServer()
+{
+	rendering->waitForFinished();
+}
+
+void RenderServer::setOutputTemplate(QString t)
+{
+	if(!t.isEmpty())
+		outputTemplate=t;
+}
+
+bool RenderServer::start(QString dir,QString name)
+{
+	QFileInfo info(dir);
+	if(!info.isDir()) {
+		output << "Warning: '" << dir << "' is not a directory.\n";
+		output.flush();
+		return false;
+	}
+	directory=info.absoluteFilePath();
+
+	//A server that was not shut down cleanly can leave its socket behind
+	if(!server->listen(name)) {
+		QLocalServer::removeServer(name);
+		if(!server->listen(name)) {
+			output << "Warning: cannot listen on '" << name << "': " << server->errorString() << "\n";
+			output.flush();
+			return false;
+		}
+	}
+
+	watcher->addPath(directory);
+	scan();
+
+	output << "Watching " << directory << ", listening on '" << name << "'\n";
+	output.flush();
+	return true;
+}
+
+void RenderServer::scan()
+{
+	QDir dir(directory);
+	QStringList added;
+	foreach(QString n,dir.entryList(QStringList("*.rcad"),QDir::Files,QDir::Name)) {
+		QString path=dir.absoluteFilePath(n);
+		if(!scripts.contains(path)) {
+			scripts.append(path);
+			added.append(path);
+			watch(path);
+		}
+	}
+
+	//Only queue once all are known so that libraries can be told apart
+	foreach(QString path,added)
+		changed(path);
+}
+
+void RenderServer::watch(QString path)
+{
+	if(QFileInfo(path).exists() && !watcher->files().contains(path))
+		watcher->addPath(path);
+}
+
+void RenderServer::directoryChanged(QString)
+{
+	foreach(QString path,scripts) {
+		if(!QFileInfo(path).exists()) {
+			scripts.removeAll(path);
+			pending.removeAll(path);
+			dependencies.remove(path);
+			states.remove(path);
+			times.remove(path);
+			logs.remove(path);
+		}
+	}
+	scan();
+}
+
+void RenderServer::fileChanged(QString path)
+{
+	//Files that are replaced rather than rewritten are no longer watched
+	watch(path);
+	changed(path);
+}
+
+/* Render every script that the changed file is an input of. */
+void RenderServer::changed(QString path)
+{
+	dependencies.remove(path);
+	foreach(QString dep,getDependencies(path))
+		watch(dep);
+
+	foreach(QString script,scripts)
+		if(getInputs(script).contains(path))
+			queue(script);
+}
+
+void RenderServer::queue(QString path)
+{
+	if(isLibrary(path)) {
+		states.insert(path,"library");
+		return;
+	}
+
+	if(!pending.contains(path))
+		pending.append(path);
+	states.insert(path,"pending");
+	timer->start();
+}
+
+bool RenderServer::isLibrary(QString path)
+{
+	foreach(QString script,scripts)
+		if(getDependencies(script).contains(path))
+			return true;
+	return false;
+}
+
+QStringList RenderServer::getDependencies(QString path)
+{
+	if(dependencies.contains(path))
+		return dependencies.value(path);
+
+	QStringList result;
+	if(QFileInfo(path).exists()) {
+		QString messages;
+		QTextStream s(&messages);
+		Reporter reporter(s);
+		DependencyBuilder builder;
+		parse(path,&reporter,&builder);
+		foreach(QString dep,builder.getDependencies())
+			result.append(QFileInfo(dep).absoluteFilePath());
+	}
+	dependencies.insert(path,result);
+	return result;
+}
+
+/**
+  The script itself followed by everything it depends on,
+  directly or indirectly.
+*/
+QStringList RenderServer::getInputs(QString path)
+{
+	QStringList inputs;
+	QSet<QString> visited;
+	QStringList remaining;
+	remaining.append(path);
+	while(!remaining.isEmpty()) {
+		QString p=remaining.takeFirst();
+		if(visited.contains(p))
+			continue;
+		visited.insert(p);
+		inputs.append(p);
+		remaining.append(getDependencies(p));
+	}
+	return inputs;
+}
+
+/* Only one script is rendered at a time, which the geometry cache
+ * relies on. The server keeps answering requests meanwhile. */
+void RenderServer::renderNext()
+{
+	if(rendering->isRunning())
+		return;
+
+	//A script may have become a library since it was queued
+	while(!pending.isEmpty() && isLibrary(pending.first()))
+		states.insert(pending.takeFirst(),"library");
+	if(pending.isEmpty())
+		return;
+
+	current=pending.takeFirst();
+	states.insert(current,"rendering");
+	rendering->setFuture(QtConcurrent::run(this,&RenderServer::render,current));
+}
+
+bool RenderServer::render(QString path)
+{
+	QString text;
+	QTextStream s(&text);
+	QTime t;
+	t.start();
+
+	BatchWorker w(s);
+	w.setGeometryCache(&geometry);
+	w.setup(path,BatchRunner::getOutput(outputTemplate,path),false);
+	w.evaluate();
+
+	s.flush();
+	renderLog=text;
+	renderTime=t.elapsed();
+	return w.isExported();
+}
+
+void RenderServer::renderDone()
+{
+	bool built=rendering->result();
+	if(scripts.contains(current)) {
+		states.insert(current,built?"done":"failed");
+		times.insert(current,renderTime);
+		logs.insert(current,renderLog);
+	}
+	output << (built?"Rendered ":"Failed ") << current << QString(" in %1ms.\n").arg(renderTime);
+	output.flush();
+
+	current=QString();
+	renderNext();
+}
+
+QString RenderServer::getPath(QString name)
+{
+	return QDir::cleanPath(QDir(directory).absoluteFilePath(name));
+}
+
+QString RenderServer::getStatus(QString path)
+{
+	return QString("%1 %2 %3\n").arg(states.value(path,"unknown")).arg(path).arg(times.value(path));
+}
+
+QString RenderServer::handle(QString request)
+{
+	QString command=request.section(' ',0,0);
+	QString argument=request.section(' ',1).trimmed();
+
+	if(command=="status") {
+		QString reply;
+		if(argument.isEmpty()) {
+			foreach(QString path,scripts)
+				reply.append(getStatus(path));
+		} else {
+			QString path=getPath(argument);
+			if(!scripts.contains(path))
+				return "error unknown file\n";
+			reply.append(getStatus(path));
+		}
+		return reply+"ok\n";
+	}
+
+	if(command=="render") {
+		QString path=getPath(argument);
+		if(!scripts.contains(path))
+			return "error unknown file\n";
+		queue(path);
+		return "ok\n";
+	}
+
+	if(command=="log") {
+		QString path=getPath(argument);
+		if(!logs.contains(path))
+			return "error no log\n";
+		QString log=logs.value(path);
+		if(!log.isEmpty() && !log.endsWith('\n'))
+			log.append('\n');
+		return log+"ok\n";
+	}
+
+	if(command=="quit") {
+		QCoreApplication::quit();
+		return "ok\n";
+	}
+
+	return "error unknown request\n";
+}
+
+void RenderServer::newConnection()
+{
+	while(server->hasPendingConnections()) {
+		QLocalSocket* s=server->nextPendingConnection();
+		connect(s,SIGNAL(readyRead()),this,SLOT(readRequest()));
+		connect(s,SIGNAL(disconnected()),s,SLOT(deleteLater()));
+	}
+}
+
+void RenderServer::readRequest()
+{
+	QLocalSocket* s=qobject_cast<QLocalSocket*>(sender());
+	if(!s)
+		return;
+
+	while(s->canReadLine()) {
+		QString request=QString::fromUtf8(s->readLine()).trimmed();
+		if(!request.isEmpty())
+			s->write(handle(request).toUtf8());
+	}
+	s->flush();
+}
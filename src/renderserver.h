@@ -0,0 +1,98 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDERSERVER_H
+#define RENDERSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QTextStream>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include "geometrycache.h"
+
+/**
+  Watches the scripts in a directory and renders them again whenever
+  they, or anything they include, use or import, change. The parsed
+  libraries and the geometry of unchanged subtrees are kept between
+  renders. Scripts that other scripts depend on are treated as libraries
+  and are not rendered themselves.
+
+  Requests are accepted on a local socket, one per line:
+
+    status [file]   the state and last render time of the scripts
+    render file     render the file again
+    log file        the output of the last render of the file
+    quit            stop the server
+
+  Every reply ends with a line reading "ok", or "error" followed by
+  the reason.
+*/
+class RenderServer : public QObject
+{
+	Q_OBJECT
+public:
+	RenderServer(QTextStream&,QObject* parent = 0);
+	~RenderServer();
+	void setOutputTemplate(QString);
+	bool start(QString,QString);
+private slots:
+	void directoryChanged(QString);
+	void fileChanged(QString);
+	void newConnection();
+	void readRequest();
+	void renderNext();
+	void renderDone();
+private:
+	void scan();
+	void watch(QString);
+	void queue(QString);
+	void changed(QString);
+	bool isLibrary(QString);
+	QStringList getDependencies(QString);
+	QStringList getInputs(QString);
+	QString getPath(QString);
+	QString getStatus(QString);
+	QString handle(QString);
+	bool render(QString);
+
+	QTextStream& output;
+	QString directory;
+	QString outputTemplate;
+	QFileSystemWatcher* watcher;
+	QLocalServer* server;
+	QTimer* timer;
+	QFutureWatcher<bool>* rendering;
+	QString current;
+	QStringList scripts;
+	QStringList pending;
+	QHash<QString,QStringList> dependencies;
+	QHash<QString,QString> states;
+	QHash<QString,int> times;
+	QHash<QString,QString> logs;
+	QString renderLog;
+	int renderTime;
+	GeometryCache geometry;
+};
+
+#endif // RENDERSERVER_H
@@ -20,22 +20,54 @@
 
 Reporter::Reporter(QTextStream& s) : output(s)
 {
+	errorCount=0;
+	diagnostics=NULL;
 }
 
 void Reporter::reportSyntaxError(AbstractTokenBuilder* t, QString msg, QString text)
 {
 	int pos=t->getPosition();
 	int line=t->getLineNumber();
-	output << "line " << line << ": " << msg << " at character " << pos << ": '" << text << "'.\n";
+	errorCount++;
+	Diagnostic* d=new Diagnostic(Diagnostic::SyntaxError,QStringList() << msg << QString::number(pos) << text);
+	d->setLocation(t->getFileName(),line);
+	report(d);
 }
 
 void Reporter::reportLexicalError(AbstractTokenBuilder* t, QString text)
 {
 	int line=t->getLineNumber();
-	output << line << ": illegal token '" << text << "'.\n";
+	errorCount++;
+	Diagnostic* d=new Diagnostic(Diagnostic::IllegalToken,QStringList(text));
+	d->setLocation(t->getFileName(),line);
+	report(d);
 }
 
 void Reporter::reportFileMissingError(QString fullpath)
 {
-	output << "Can't open input file '" << fullpath << "'\n";
+	errorCount++;
+	report(new Diagnostic(Diagnostic::FileMissing,QStringList(fullpath)));
+}
+
+int Reporter::getErrorCount() const
+{
+	return errorCount;
+}
+
+/**
+  Once set, errors are queued on the sink instead of being printed.
+*/
+void Reporter::setDiagnostics(DiagnosticSink* d)
+{
+	diagnostics=d;
+}
+
+void Reporter::report(Diagnostic* d)
+{
+	if(diagnostics) {
+		diagnostics->report(d);
+		return;
+	}
+	output << d->getMessage() << "\n";
+	delete d;
 }
@@ -21,6 +21,7 @@
 
 #include <QTextStream>
 #include "abstracttokenbuilder.h"
+#include "diagnosticsink.h"
 
 class Reporter
 {
@@ -29,8 +30,13 @@ public:
 	void reportSyntaxError(AbstractTokenBuilder*,QString,QString);
 	void reportLexicalError(AbstractTokenBuilder*,QString);
 	void reportFileMissingError(QString);
+	int getErrorCount() const;
+	void setDiagnostics(DiagnosticSink*);
 private:
+	void report(Diagnostic*);
 	QTextStream& output;
+	DiagnosticSink* diagnostics;
+	int errorCount;
 };
 
 #endif // REPORTER_H
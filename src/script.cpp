@@ -17,6 +17,7 @@
  */
 
 #include "script.h"
+#include "scriptcache.h"
 
 Script::Script()
 {
@@ -24,8 +25,19 @@ Script::Script()
 
 Script::~Script()
 {
+	/* Declarations spliced in from included scripts belong to the
+	 * script cache, so only delete our own. */
+	QSet<Declaration*> shared;
+	foreach(Script* s,includes)
+		foreach(Declaration* d,s->getDeclarations())
+			shared.insert(d);
+
 	for(int i =0; i<declarations.size(); i++)
-		delete declarations.at(i);
+		if(!shared.contains(declarations.at(i)))
+			delete declarations.at(i);
+
+	foreach(Script* s,includes)
+		ScriptCache::getInstance()->release(s);
 }
 
 void Script::setDeclarations(QList<Declaration*> decls)
@@ -48,6 +60,21 @@ void Script::removeDeclaration(Declaration* dec)
 	declarations.removeAll(dec);
 }
 
+void Script::setFileName(QString name)
+{
+	fileName=name;
+}
+
+QString Script::getFileName() const
+{
+	return fileName;
+}
+
+void Script::addInclude(Script* sc)
+{
+	includes.append(sc);
+}
+
 void Script::addDocumentation(QList<CodeDoc*> docs)
 {
 	documentation.append(docs);
@@ -20,6 +20,7 @@
 #define SCRIPT_H
 
 #include <QList>
+#include <QSet>
 #include "declaration.h"
 #include "scope.h"
 #include "codedoc.h"
@@ -34,11 +35,16 @@ public:
 	QList<Declaration*> getDeclarations() const;
 	void addDeclaration(Declaration*);
 	void removeDeclaration(Declaration*);
+	void addInclude(Script*);
+	void setFileName(QString);
+	QString getFileName() const;
 	void addDocumentation(QList<CodeDoc*>);
 	QList<QList<CodeDoc*> > getDocumentation();
 	void accept(TreeVisitor&);
 private:
 	QList<Declaration*> declarations;
+	QList<Script*> includes;
+	QString fileName;
 	QList<QList<CodeDoc*> > documentation;
 };
 
@@ -0,0 +1,147 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFileInfo>
+#include "scriptcache.h"
+
+extern Script* parse(QString,Reporter*);
+
+QAtomicPointer<ScriptCache> ScriptCache::instance;
+
+ScriptCache::ScriptCache()
+{
+}
+
+/**
+  Safe to call from any thread. If two threads race to create the
+  instance the loser's copy is discarded.
+*/
+ScriptCache* ScriptCache::getInstance()
+{
+	ScriptCache* i=instance;
+	if(!i) {
+		i=new ScriptCache();
+		if(!instance.testAndSetOrdered(NULL,i)) {
+			delete i;
+			i=instance;
+		}
+	}
+	return i;
+}
+
+Script* ScriptCache::getScript(QString path,Reporter* r)
+{
+	QFileInfo info(path);
+	if(!info.exists()) {
+		/* Missing files are not cached, the script is only kept until it
+		 * is released so that the error is reported every time. */
+		Script* s=parse(info.absoluteFilePath(),r);
+		lock.lock();
+		users[s]++;
+		stale.insert(s);
+		lock.unlock();
+		return s;
+	}
+	QString key=info.canonicalFilePath();
+	if(key.isEmpty())
+		key=info.absoluteFilePath();
+
+	Entry e;
+	e.modified=info.lastModified();
+	e.size=info.size();
+
+	lock.lock();
+	if(entries.contains(key)) {
+		Entry old=entries.value(key);
+		if(old.valid && old.modified==e.modified && old.size==e.size) {
+			users[old.script]++;
+			lock.unlock();
+			return old.script;
+		}
+	}
+	lock.unlock();
+
+	/* Parse outside of the lock since the file may itself include
+	 * other files. Scripts that had errors are kept but re-parsed
+	 * next time so that the errors are reported again. */
+	QString discard;
+	QTextStream s(&discard);
+	Reporter quiet(s);
+	if(!r)
+		r=&quiet;
+	int errors=r->getErrorCount();
+	e.script=parse(key,r);
+	e.valid=r->getErrorCount()==errors;
+
+	QList<Script*> unused;
+	lock.lock();
+	if(entries.contains(key)) {
+		Entry old=entries.value(key);
+		if(old.valid && old.modified==e.modified && old.size==e.size) {
+			unused.append(e.script);
+			e=old;
+		} else {
+			retire(old.script,unused);
+			entries.insert(key,e);
+		}
+	} else {
+		entries.insert(key,e);
+	}
+	users[e.script]++;
+	lock.unlock();
+
+	//Deleting a script releases its own includes, so do it unlocked.
+	foreach(Script* s,unused)
+		delete s;
+
+	return e.script;
+}
+
+void ScriptCache::release(Script* s)
+{
+	lock.lock();
+	bool unused=--users[s]<=0;
+	if(unused)
+		users.remove(s);
+	unused=unused && stale.remove(s);
+	lock.unlock();
+
+	if(unused)
+		delete s;
+}
+
+void ScriptCache::retire(Script* s,QList<Script*>& unused)
+{
+	if(users.value(s)>0)
+		stale.insert(s);
+	else
+		unused.append(s);
+}
+
+void ScriptCache::clear()
+{
+	QList<Script*> unused;
+	lock.lock();
+	foreach(Entry e,entries)
+		retire(e.script,unused);
+	entries.clear();
+	lock.unlock();
+
+	foreach(Script* s,unused)
+		delete s;
+}
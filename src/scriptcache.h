@@ -0,0 +1,62 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTCACHE_H
+#define SCRIPTCACHE_H
+
+#include <QString>
+#include <QAtomicPointer>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include <QMutex>
+#include "script.h"
+#include "reporter.h"
+
+/**
+  Keeps the parsed syntax tree of included files so that libraries
+  which have not changed on disk are only parsed once. Entries are
+  keyed on the canonical path and validated against the modification
+  time and size of the file. Every script handed out by getScript()
+  must be given back with release() once the including script is
+  done with it, stale scripts are only deleted when nobody uses them.
+*/
+class ScriptCache
+{
+public:
+	static ScriptCache* getInstance();
+	Script* getScript(QString,Reporter*);
+	void release(Script*);
+	void clear();
+private:
+	ScriptCache();
+	struct Entry {
+		QDateTime modified;
+		qint64 size;
+		bool valid;
+		Script* script;
+	};
+	void retire(Script*,QList<Script*>&);
+	static QAtomicPointer<ScriptCache> instance;
+	QHash<QString,Entry> entries;
+	QHash<Script*,int> users;
+	QSet<Script*> stale;
+	QMutex lock;
+};
+
+#endif // SCRIPTCACHE_H
@@ -0,0 +1,138 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFileInfo>
+#include "scriptlibrary.h"
+#include "scriptcache.h"
+#include "scriptimport.h"
+#include "reporter.h"
+
+ScriptLibrary::ScriptLibrary(QString p,QTextStream& s) : output(s)
+{
+	path=p;
+	script=NULL;
+	loaded=false;
+}
+
+ScriptLibrary::~ScriptLibrary()
+{
+	foreach(ScriptLibrary* lib,imports)
+		delete lib;
+
+	if(script)
+		ScriptCache::getInstance()->release(script);
+}
+
+/**
+  Loads the library the first time it is needed. Only threads that need
+  this library wait for it, after loading its names are only read.
+*/
+void ScriptLibrary::load()
+{
+	QMutexLocker locker(&loading);
+	if(loaded)
+		return;
+	loaded=true;
+
+	QFileInfo info(path);
+	if(!info.exists()) {
+		output << "Warning: cannot find library '" << path << "'.\n";
+		return;
+	}
+
+	Reporter r(output);
+	script=ScriptCache::getInstance()->getScript(path,&r);
+
+	foreach(Declaration* d,script->getDeclarations()) {
+		Module* mod=dynamic_cast<Module*>(d);
+		if(mod) {
+			modules.insert(mod->getSymbol(),mod);
+			continue;
+		}
+		Function* func=dynamic_cast<Function*>(d);
+		if(func) {
+			functions.insert(func->getSymbol(),func);
+			continue;
+		}
+		ScriptImport* imp=dynamic_cast<ScriptImport*>(d);
+		if(imp)
+			imports.append(new ScriptLibrary(imp->getImport(),output));
+	}
+}
+
+/* Libraries that use each other each get their own instance of the
+ * other, so they are told apart by the file they were read from. */
+QString ScriptLibrary::getKey() const
+{
+	QFileInfo info(path);
+	QString key=info.canonicalFilePath();
+	return key.isEmpty()?info.absoluteFilePath():key;
+}
+
+Module* ScriptLibrary::lookupModule(int name)
+{
+	QList<QString> visited;
+	return lookupModule(name,visited);
+}
+
+Module* ScriptLibrary::lookupModule(int name,QList<QString>& visited)
+{
+	//Guard against libraries that use each other
+	QString key=getKey();
+	if(visited.contains(key))
+		return NULL;
+	visited.append(key);
+
+	load();
+
+	if(modules.contains(name))
+		return modules.value(name);
+
+	foreach(ScriptLibrary* lib,imports) {
+		Module* mod=lib->lookupModule(name,visited);
+		if(mod)
+			return mod;
+	}
+	return NULL;
+}
+
+Function* ScriptLibrary::lookupFunction(int name)
+{
+	QList<QString> visited;
+	return lookupFunction(name,visited);
+}
+
+Function* ScriptLibrary::lookupFunction(int name,QList<QString>& visited)
+{
+	QString key=getKey();
+	if(visited.contains(key))
+		return NULL;
+	visited.append(key);
+
+	load();
+
+	if(functions.contains(name))
+		return functions.value(name);
+
+	foreach(ScriptLibrary* lib,imports) {
+		Function* func=lib->lookupFunction(name,visited);
+		if(func)
+			return func;
+	}
+	return NULL;
+}
@@ -0,0 +1,57 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTLIBRARY_H
+#define SCRIPTLIBRARY_H
+
+#include <QHash>
+#include <QList>
+#include <QTextStream>
+#include <QMutex>
+#include "script.h"
+#include "module.h"
+#include "function.h"
+
+/**
+  A script brought in with use<>. Only its modules and functions are
+  visible to the script that uses it, and the file is not parsed until
+  the first time a name cannot be resolved anywhere else.
+*/
+class ScriptLibrary
+{
+public:
+	ScriptLibrary(QString,QTextStream&);
+	~ScriptLibrary();
+	Module* lookupModule(int);
+	Function* lookupFunction(int);
+private:
+	Module* lookupModule(int,QList<QString>&);
+	Function* lookupFunction(int,QList<QString>&);
+	QString getKey() const;
+	void load();
+	QString path;
+	QTextStream& output;
+	Script* script;
+	bool loaded;
+	QMutex loading;
+	QHash<int,Module*> modules;
+	QHash<int,Function*> functions;
+	QList<ScriptLibrary*> imports;
+};
+
+#endif // SCRIPTLIBRARY_H
@@ -0,0 +1,272 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sideeffectchecker.h"
+#include "module/echomodule.h"
+#include "function/randfunction.h"
+#include "symboltable.h"
+
+SideEffectChecker::SideEffectChecker(Context* ctx)
+{
+	context=ctx;
+	sideEffects=false;
+}
+
+bool SideEffectChecker::hasSideEffects(Statement* stmt)
+{
+	sideEffects=false;
+	scopes.clear();
+	stmt->accept(*this);
+	return sideEffects;
+}
+
+Module* SideEffectChecker::lookupModule(int name)
+{
+	for(int i=scopes.size()-1; i>=0; i--) {
+		foreach(Declaration* d,scopes.at(i)->getDeclarations()) {
+			Module* mod = dynamic_cast<Module*>(d);
+			if(mod && mod->getSymbol() == name)
+				return mod;
+		}
+	}
+	return context->lookupModule(name);
+}
+
+Function* SideEffectChecker::lookupFunction(int name)
+{
+	for(int i=scopes.size()-1; i>=0; i--) {
+		foreach(Declaration* d,scopes.at(i)->getDeclarations()) {
+			Function* func = dynamic_cast<Function*>(d);
+			if(func && func->getSymbol() == name)
+				return func;
+		}
+	}
+	return context->lookupFunction(name);
+}
+
+void SideEffectChecker::visitScope(Scope* scp)
+{
+	//Recursive modules and functions only need to be checked once
+	if(!scp || scopes.contains(scp))
+		return;
+
+	scopes.append(scp);
+	scp->accept(*this);
+	scopes.removeLast();
+}
+
+void SideEffectChecker::visit(Module*)
+{
+}
+
+void SideEffectChecker::visit(ModuleScope* scp)
+{
+	foreach(Declaration* d, scp->getDeclarations())
+		d->accept(*this);
+}
+
+void SideEffectChecker::visit(Instance* inst)
+{
+	foreach(Statement* s, inst->getChildren())
+		s->accept(*this);
+
+	foreach(Argument* arg, inst->getArguments())
+		arg->accept(*this);
+
+	Module* mod=lookupModule(inst->getSymbol());
+	if(!mod)
+		return;
+
+	if(dynamic_cast<EchoModule*>(mod)) {
+		sideEffects=true;
+		return;
+	}
+
+	foreach(Parameter* p, mod->getParameters())
+		p->accept(*this);
+
+	visitScope(mod->getScope());
+}
+
+void SideEffectChecker::visit(Function*)
+{
+}
+
+void SideEffectChecker::visit(FunctionScope* scp)
+{
+	Expression* e=scp->getExpression();
+	if(e)
+		e->accept(*this);
+
+	foreach(Statement* s, scp->getStatements())
+		s->accept(*this);
+}
+
+void SideEffectChecker::visit(CompoundStatement* stmt)
+{
+	foreach(Statement* s, stmt->getChildren())
+		s->accept(*this);
+}
+
+void SideEffectChecker::visit(IfElseStatement* ifelse)
+{
+	ifelse->getExpression()->accept(*this);
+	ifelse->getTrueStatement()->accept(*this);
+	Statement* falseStmt=ifelse->getFalseStatement();
+	if(falseStmt)
+		falseStmt->accept(*this);
+}
+
+void SideEffectChecker::visit(ForStatement* forstmt)
+{
+	foreach(Argument* arg, forstmt->getArguments())
+		arg->accept(*this);
+
+	forstmt->getStatement()->accept(*this);
+}
+
+void SideEffectChecker::visit(Parameter* param)
+{
+	Expression* e=param->getExpression();
+	if(e)
+		e->accept(*this);
+}
+
+void SideEffectChecker::visit(BinaryExpression* exp)
+{
+	exp->getLeft()->accept(*this);
+	exp->getRight()->accept(*this);
+}
+
+void SideEffectChecker::visit(Argument* arg)
+{
+	arg->getExpression()->accept(*this);
+}
+
+void SideEffectChecker::visit(AssignStatement* stmt)
+{
+	//Assignments outside of a module or function scope
+	//modify the context in which the statement is evaluated
+	if(scopes.isEmpty()) {
+		sideEffects=true;
+		return;
+	}
+
+	Expression* e=stmt->getExpression();
+	if(e)
+		e->accept(*this);
+}
+
+void SideEffectChecker::visit(VectorExpression* exp)
+{
+	foreach(Expression* e, exp->getChildren())
+		e->accept(*this);
+}
+
+void SideEffectChecker::visit(RangeExpression* exp)
+{
+	exp->getStart()->accept(*this);
+	Expression* step=exp->getStep();
+	if(step)
+		step->accept(*this);
+	exp->getFinish()->accept(*this);
+}
+
+void SideEffectChecker::visit(UnaryExpression* exp)
+{
+	exp->getExpression()->accept(*this);
+}
+
+void SideEffectChecker::visit(ReturnStatement* stmt)
+{
+	if(scopes.isEmpty()) {
+		sideEffects=true;
+		return;
+	}
+
+	stmt->getExpression()->accept(*this);
+}
+
+void SideEffectChecker::visit(TernaryExpression* exp)
+{
+	exp->getCondition()->accept(*this);
+	exp->getTrueExpression()->accept(*this);
+	exp->getFalseExpression()->accept(*this);
+}
+
+bool SideEffectChecker::hasSeed(Invocation* stmt)
+{
+	QList<Argument*> args=stmt->getArguments();
+	if(args.size()>3)
+		return true;
+
+	int seed=SymbolTable::getInstance()->intern("seed");
+	foreach(Argument* arg, args) {
+		Variable* var=arg->getVariable();
+		if(var && var->getSymbol()==seed)
+			return true;
+	}
+	return false;
+}
+
+void SideEffectChecker::visit(Invocation* stmt)
+{
+	foreach(Argument* arg, stmt->getArguments())
+		arg->accept(*this);
+
+	Function* func=lookupFunction(stmt->getSymbol());
+	if(!func)
+		return;
+
+	//Without a seed rands() gives different numbers on every call
+	if(dynamic_cast<RandFunction*>(func) && !hasSeed(stmt)) {
+		sideEffects=true;
+		return;
+	}
+
+	foreach(Parameter* p, func->getParameters())
+		p->accept(*this);
+
+	visitScope(func->getScope());
+}
+
+void SideEffectChecker::visit(ModuleImport*)
+{
+	sideEffects=true;
+}
+
+void SideEffectChecker::visit(ScriptImport*)
+{
+	sideEffects=true;
+}
+
+void SideEffectChecker::visit(Literal*)
+{
+}
+
+void SideEffectChecker::visit(Variable*)
+{
+}
+
+void SideEffectChecker::visit(CodeDoc*)
+{
+}
+
+void SideEffectChecker::visit(Script*)
+{
+}
@@ -0,0 +1,70 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIDEEFFECTCHECKER_H
+#define SIDEEFFECTCHECKER_H
+
+#include <QList>
+#include "treevisitor.h"
+#include "treeevaluator.h"
+
+/* Checks whether a statement does nothing but produce nodes, which
+ * means its evaluation can be repeated in isolation from the
+ * surrounding context. Modules and functions that it calls are
+ * checked as well. */
+class SideEffectChecker : public TreeVisitor
+{
+public:
+	SideEffectChecker(Context*);
+	bool hasSideEffects(Statement*);
+	void visit(Module*);
+	void visit(ModuleScope*);
+	void visit(Instance*);
+	void visit(Function*);
+	void visit(FunctionScope*);
+	void visit(CompoundStatement*);
+	void visit(IfElseStatement*);
+	void visit(ForStatement*);
+	void visit(Parameter*);
+	void visit(BinaryExpression*);
+	void visit(Argument*);
+	void visit(AssignStatement*);
+	void visit(VectorExpression*);
+	void visit(RangeExpression*);
+	void visit(UnaryExpression*);
+	void visit(ReturnStatement*);
+	void visit(TernaryExpression*);
+	void visit(Invocation*);
+	void visit(ModuleImport*);
+	void visit(ScriptImport*);
+	void visit(Literal*);
+	void visit(Variable*);
+	void visit(CodeDoc*);
+	void visit(Script*);
+private:
+	Module* lookupModule(int);
+	Function* lookupFunction(int);
+	void visitScope(Scope*);
+	bool hasSeed(Invocation*);
+
+	Context* context;
+	QList<Scope*> scopes;
+	bool sideEffects;
+};
+
+#endif // SIDEEFFECTCHECKER_H
@@ -0,0 +1,70 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "symboltable.h"
+
+SymbolTable::SymbolTable()
+{
+	intern(QString());
+}
+
+QAtomicPointer<SymbolTable> SymbolTable::instance;
+
+/**
+  Safe to call from any thread. If two threads race to create the
+  instance the loser's copy is discarded.
+*/
+SymbolTable* SymbolTable::getInstance()
+{
+	SymbolTable* i=instance;
+	if(!i) {
+		i=new SymbolTable();
+		if(!instance.testAndSetOrdered(NULL,i)) {
+			delete i;
+			i=instance;
+		}
+	}
+	return i;
+}
+
+int SymbolTable::intern(QString name)
+{
+	lock.lockForRead();
+	QHash<QString,int>::const_iterator i=symbols.constFind(name);
+	bool found=(i!=symbols.constEnd());
+	int symbol=found?i.value():0;
+	lock.unlock();
+	if(found)
+		return symbol;
+
+	QWriteLocker locker(&lock);
+	//Another thread could have interned the name in the meantime
+	if(symbols.contains(name))
+		return symbols.value(name);
+
+	symbol=names.size();
+	names.append(name);
+	symbols.insert(name,symbol);
+	return symbol;
+}
+
+QString SymbolTable::lookup(int symbol)
+{
+	QReadLocker locker(&lock);
+	return names.at(symbol);
+}
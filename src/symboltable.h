@@ -0,0 +1,47 @@
+/*
+ *   RapCAD - Rapid prototyping CAD IDE (www.rapcad.org)
+ *   Copyright (C) 2010-2013 Giles Bathgate
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QString>
+#include <QAtomicPointer>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+
+/**
+  Interns identifiers into compact integer symbols. The empty string is
+  always symbol 0 so that unnamed values and arguments can be tested with
+  a simple integer comparison.
+*/
+class SymbolTable
+{
+public:
+	static SymbolTable* getInstance();
+	int intern(QString);
+	QString lookup(int);
+private:
+	SymbolTable();
+	static QAtomicPointer<SymbolTable> instance;
+	QHash<QString,int> symbols;
+	QList<QString> names;
+	QReadWriteLock lock;
+};
+
+#endif // SYMBOLTABLE_H
@@ -16,486 +16,129 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QtConcurrentRun>
 #include "syntaxhighlighter.h"
-#include "reporter.h"
 
-extern int lexerlex_destroy();
-extern void lexerinit(AbstractTokenBuilder*,Reporter*,QString,bool);
-extern int lexerlex();
-extern void lexerbegin();
-extern void lexercomment();
-extern void lexercodedoc();
-extern int lexerleng;
-#define YY_CONTINUE 1;
+/* Edits that insert more than this many characters, such as loading or
+ pasting a large script, are lexed in the background. */
+static const int LargeEdit=32768;
 
 SyntaxHighlighter::SyntaxHighlighter(QTextDocument* parent)
-	: QSyntaxHighlighter(parent)
-{
-	keywordFormat.setForeground(Qt::darkBlue);
-	keywordFormat.setFontWeight(QFont::Bold);
-
-	numberFormat.setForeground(Qt::red);
-
-	operatorFormat.setForeground(Qt::darkMagenta);
-
-	errorFormat.setBackground(Qt::red);
-
-	stringFormat.setForeground(Qt::darkGreen);
-
-	codeDocFormat.setForeground(Qt::darkBlue);
-
-	codeDocParamFormat.setForeground(Qt::blue);
-	codeDocParamFormat.setFontWeight(QFont::Bold);
-}
-
-void SyntaxHighlighter::highlightBlock(const QString& text)
-{
-	startIndex=0;
-	lexerinit(this,NULL,text,false);
-
-	//Force lexer into correct state
-	switch(previousBlockState()) {
-	case Initial:
-		lexerbegin();
-		break;
-	case Comment:
-		lexercomment();
-		break;
-	case CodeDoc:
-		lexercodedoc();
-		break;
+	: QSyntaxHighlighter(static_cast<QObject*>(parent))
+{
+	firstBlock=0;
+	deferred=false;
+	restart=false;
+	lexing=new QFutureWatcher<QList<BlockData*> >(this);
+	connect(lexing,SIGNAL(finished()),this,SLOT(lexingDone()));
+
+	/* Connect before the document is attached so that large edits are
+	 seen before QSyntaxHighlighter starts reformatting them. */
+	if(parent) {
+		connect(parent,SIGNAL(contentsChange(int,int,int)),this,SLOT(contentsChange(int,int,int)));
+		setDocument(parent);
 	}
-
-	while(nextToken());
-
-}
-
-void SyntaxHighlighter::stop()
-{
-	lexerlex_destroy();
-}
-
-int SyntaxHighlighter::nextToken()
-{
-	int res=lexerlex();
-	startIndex+=lexerleng;
-	return res;
-}
-
-int SyntaxHighlighter::getPosition() const
-{
-	return startIndex;
-}
-
-int SyntaxHighlighter::getLineNumber() const
-{
-	return 1; /*TODO for now we don't really care what line
-	we are on for syntax highlighting */
-}
-
-void SyntaxHighlighter::buildIncludeStart()
-{
-	setFormat(startIndex,lexerleng-1,keywordFormat);
-	startIndex+=lexerleng;
-}
-
-void SyntaxHighlighter::buildIncludeFile(QString)
-{
-	setFormat(startIndex,lexerleng,stringFormat);
-	startIndex+=lexerleng;
-}
-
-void SyntaxHighlighter::buildIncludePath(QString)
-{
-	setFormat(startIndex,lexerleng,stringFormat);
-	startIndex+=lexerleng;
-}
-
-void SyntaxHighlighter::buildIncludeFinish()
-{
-	startIndex++;
-}
-
-void SyntaxHighlighter::buildUseStart()
-{
-	setFormat(startIndex,lexerleng-1,keywordFormat);
-	startIndex+=lexerleng;
-}
-
-unsigned int SyntaxHighlighter::buildUse(QString)
-{
-	setFormat(startIndex,lexerleng,stringFormat);
-	return YY_CONTINUE;
-}
-
-void SyntaxHighlighter::buildUseFinish()
-{
-	startIndex++;
-}
-
-void SyntaxHighlighter::buildImportStart()
-{
-	setFormat(startIndex,lexerleng-1,keywordFormat);
-	startIndex+=lexerleng;
-}
-
-unsigned int SyntaxHighlighter::buildImport(QString)
-{
-	setFormat(startIndex,lexerleng,stringFormat);
-	return YY_CONTINUE;
-}
-
-void SyntaxHighlighter::buildImportFinish()
-{
-	startIndex++;
-}
-
-unsigned int SyntaxHighlighter::buildModule()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildFunction()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildTrue()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildFalse()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildUndef()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildConst()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildParam()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildIf()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAs()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildElse()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildFor()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildReturn()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildLessEqual()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildGreatEqual()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildEqual()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildNotEqual()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAnd()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildOr()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildComponentwiseMultiply()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildComponentwiseDivide()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildIncrement()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildDecrement()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAddAssign()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildSubtractAssign()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildOuterProduct()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildNamespace()
-{
-	setFormat(startIndex,lexerleng,keywordFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAssign()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAdd()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
 }
 
-unsigned int SyntaxHighlighter::buildSubtract()
+SyntaxHighlighter::~SyntaxHighlighter()
 {
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildTernaryCondition()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildTernaryAlternate()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildNot()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildMultiply()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildDivide()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildModulus()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildConcatenate()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildAppend()
-{
-	setFormat(startIndex,lexerleng,operatorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildLegalChar(unsigned int)
-{
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildIllegalChar()
-{
-	setFormat(startIndex,lexerleng,errorFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildNumber(QString)
-{
-	setFormat(startIndex,lexerleng,numberFormat);
-	return YY_CONTINUE;
-}
-
-unsigned int SyntaxHighlighter::buildIdentifier(QString)
-{
-	return YY_CONTINUE;
-}
-
-void SyntaxHighlighter::buildStringStart()
-{
-	stringStart=startIndex;
-	startIndex++;
-}
-
-void SyntaxHighlighter::buildString(QChar)
-{
-	startIndex++;
-}
-
-void SyntaxHighlighter::buildString(QString)
-{
-	startIndex+=lexerleng;
-}
-
-unsigned int SyntaxHighlighter::buildStringFinish()
-{
-	int stringLen=(startIndex+1)-stringStart;
-	setFormat(stringStart,stringLen,stringFormat);
-	return YY_CONTINUE;
-}
-
-void SyntaxHighlighter::buildCommentStart()
-{
-	setCurrentBlockState(Comment);
-	setFormat(startIndex,lexerleng,stringFormat);
-	startIndex+=lexerleng;
+	/* Results that have not been handed to blocks yet are still owned
+	 by the highlighter. */
+	if(deferred) {
+		lexing->waitForFinished();
+		qDeleteAll(lexing->result());
+	}
 }
 
-unsigned int SyntaxHighlighter::buildComment(QString)
+void SyntaxHighlighter::highlightBlock(const QString& text)
 {
-	if(previousBlockState()==Comment)
-		setCurrentBlockState(Comment);
-
-	setFormat(startIndex,lexerleng,stringFormat);
-	return YY_CONTINUE;
-}
+	int state=previousBlockState();
+	BlockData* data=static_cast<BlockData*>(currentBlockUserData());
+	if(!data || data->startState!=state || data->text!=text) {
+		if(deferred) {
+			/* Leave the block plain until the background lexing
+			 finishes and the whole document is rehighlighted. */
+			setCurrentBlockState(state);
+			return;
+		}
+		data=new BlockData();
+		data->text=text;
+		data->startState=state;
+		data->endState=lexer.lex(text,state,data->formats);
+		setCurrentBlockUserData(data);
+	}
 
-void SyntaxHighlighter::buildCommentFinish()
-{
-	setCurrentBlockState(Initial);
-	setFormat(startIndex,lexerleng,stringFormat);
-	startIndex+=lexerleng;
-}
+	foreach(QTextLayout::FormatRange r,data->formats)
+		setFormat(r.start,r.length,r.format);
 
-unsigned int SyntaxHighlighter::buildCodeDocStart()
-{
-	setCurrentBlockState(CodeDoc);
-	setFormat(startIndex,lexerleng,codeDocFormat);
-	return YY_CONTINUE;
+	setCurrentBlockState(data->endState);
 }
 
-unsigned int SyntaxHighlighter::buildCodeDoc(QString)
+void SyntaxHighlighter::contentsChange(int position,int,int added)
 {
-	if(previousBlockState()==CodeDoc)
-		setCurrentBlockState(CodeDoc);
-
-	setFormat(startIndex,lexerleng,codeDocFormat);
-	return YY_CONTINUE;
-}
+	if(added<LargeEdit)
+		return;
 
-void SyntaxHighlighter::buildCodeDoc()
-{
-	if(previousBlockState()==CodeDoc)
-		setCurrentBlockState(CodeDoc);
+	QTextBlock block=document()->findBlock(position);
+	if(!deferred || block.blockNumber()<firstBlock)
+		firstBlock=block.blockNumber();
+	deferred=true;
 
-	setFormat(startIndex,lexerleng,codeDocFormat);
-	startIndex+=lexerleng;
+	if(lexing->isRunning())
+		restart=true;
+	else
+		startLexing();
 }
 
-unsigned int SyntaxHighlighter::buildCodeDocParam(QString)
+void SyntaxHighlighter::startLexing()
 {
-	setFormat(startIndex,lexerleng,codeDocParamFormat);
-	return YY_CONTINUE;
-}
+	QTextBlock block=document()->findBlockByNumber(firstBlock);
+	int state=block.previous().userState();
 
-unsigned int SyntaxHighlighter::buildCodeDocFinish()
-{
-	setCurrentBlockState(Initial);
-	setFormat(startIndex,lexerleng,codeDocFormat);
-	return YY_CONTINUE;
-}
+	QStringList lines;
+	for(; block.isValid(); block=block.next())
+		lines.append(block.text());
 
-void SyntaxHighlighter::buildWhiteSpaceError()
-{
-	setFormat(startIndex,lexerleng,errorFormat);
+	lexing->setFuture(QtConcurrent::run(&SyntaxHighlighter::lexBlocks,lines,state));
 }
 
-void SyntaxHighlighter::buildWhiteSpace()
+QList<SyntaxHighlighter::BlockData*> SyntaxHighlighter::lexBlocks(QStringList lines,int state)
 {
-	startIndex+=lexerleng;
+	HighlightLexer l;
+	QList<BlockData*> result;
+	foreach(QString text,lines) {
+		BlockData* data=new BlockData();
+		data->text=text;
+		data->startState=state;
+		state=data->endState=l.lex(text,state,data->formats);
+		result.append(data);
+	}
+	return result;
 }
 
-void SyntaxHighlighter::buildNewLine()
+void SyntaxHighlighter::lexingDone()
 {
-}
+	/* Results are only kept for blocks whose text is unchanged, anything
+	 edited in the meantime is lexed again when it is highlighted. */
+	QTextBlock block=document()->findBlockByNumber(firstBlock);
+	foreach(BlockData* data,lexing->result()) {
+		if(block.isValid() && block.text()==data->text) {
+			block.setUserData(data);
+		} else {
+			delete data;
+		}
+		block=block.next();
+	}
 
-void SyntaxHighlighter::buildFileStart(QDir)
-{
-}
+	if(restart) {
+		restart=false;
+		startLexing();
+		return;
+	}
 
-void SyntaxHighlighter::buildFileFinish()
-{
+	deferred=false;
+	rehighlight();
 }
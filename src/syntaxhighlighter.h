@@ -16,107 +16,45 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #ifndef SYNTAXHIGHLIGHTER_H
 #define SYNTAXHIGHLIGHTER_H
 
 #include <QSyntaxHighlighter>
-#include "abstracttokenbuilder.h"
+#include <QTextBlockUserData>
+#include <QFutureWatcher>
+#include "highlightlexer.h"
 
-class SyntaxHighlighter : public QSyntaxHighlighter, private AbstractTokenBuilder
+class SyntaxHighlighter : public QSyntaxHighlighter
 {
 	Q_OBJECT
 public:
 	SyntaxHighlighter(QTextDocument* parent = 0);
-	void stop();
+	~SyntaxHighlighter();
 protected:
 	void highlightBlock(const QString& text);
+private slots:
+	void contentsChange(int,int,int);
+	void lexingDone();
 private:
-	enum Blockstate_e {
-		Initial=-1,
-		Comment,
-		CodeDoc
+	/* The formats of a block are kept with the text and start state they
+	 were lexed from, so they can be reapplied until either changes. */
+	class BlockData : public QTextBlockUserData
+	{
+	public:
+		QString text;
+		int startState;
+		int endState;
+		QList<QTextLayout::FormatRange> formats;
 	};
 
-	int nextToken();
-	int getPosition() const;
-	int getLineNumber() const;
-	void buildIncludeStart();
-	void buildIncludeFile(QString);
-	void buildIncludePath(QString);
-	void buildIncludeFinish();
-	void buildUseStart();
-	unsigned int buildUse(QString);
-	void buildUseFinish();
-	void buildImportStart();
-	unsigned int buildImport(QString);
-	void buildImportFinish();
-	unsigned int buildModule();
-	unsigned int buildFunction();
-	unsigned int buildTrue();
-	unsigned int buildFalse();
-	unsigned int buildUndef();
-	unsigned int buildConst();
-	unsigned int buildParam();
-	unsigned int buildIf();
-	unsigned int buildAs();
-	unsigned int buildElse();
-	unsigned int buildFor();
-	unsigned int buildReturn();
-	unsigned int buildLessEqual();
-	unsigned int buildGreatEqual();
-	unsigned int buildEqual();
-	unsigned int buildNotEqual();
-	unsigned int buildAnd();
-	unsigned int buildOr();
-	unsigned int buildComponentwiseMultiply();
-	unsigned int buildComponentwiseDivide();
-	unsigned int buildIncrement();
-	unsigned int buildDecrement();
-	unsigned int buildAddAssign();
-	unsigned int buildSubtractAssign();
-	unsigned int buildOuterProduct();
-	unsigned int buildNamespace();
-	unsigned int buildAssign();
-	unsigned int buildAdd();
-	unsigned int buildSubtract();
-	unsigned int buildTernaryCondition();
-	unsigned int buildTernaryAlternate();
-	unsigned int buildNot();
-	unsigned int buildMultiply();
-	unsigned int buildDivide();
-	unsigned int buildModulus();
-	unsigned int buildConcatenate();
-	unsigned int buildAppend();
-	unsigned int buildLegalChar(unsigned int);
-	unsigned int buildIllegalChar();
-	unsigned int buildNumber(QString);
-	unsigned int buildIdentifier(QString);
-	void buildStringStart();
-	void buildString(QChar);
-	void buildString(QString);
-	unsigned int buildStringFinish();
-	void buildCommentStart();
-	unsigned int buildComment(QString);
-	void buildCommentFinish();
-	unsigned int buildCodeDocStart();
-	unsigned int buildCodeDoc(QString);
-	void buildCodeDoc();
-	unsigned int buildCodeDocParam(QString);
-	unsigned int buildCodeDocFinish();
-	void buildWhiteSpaceError();
-	void buildWhiteSpace();
-	void buildNewLine();
-	void buildFileStart(QDir);
-	void buildFileFinish();
+	static QList<BlockData*> lexBlocks(QStringList,int);
+	void startLexing();
 
-	QTextCharFormat keywordFormat;
-	QTextCharFormat	numberFormat;
-	QTextCharFormat stringFormat;
-	QTextCharFormat errorFormat;
-	QTextCharFormat operatorFormat;
-	QTextCharFormat codeDocFormat;
-	QTextCharFormat codeDocParamFormat;
-	int startIndex;
-	int stringStart;
+	HighlightLexer lexer;
+	QFutureWatcher<QList<BlockData*> >* lexing;
+	int firstBlock;
+	bool deferred;
+	bool restart;
 };
 #endif // SYNTAXHIGHLIGHTER_H
@@ -20,6 +20,7 @@
 
 SyntaxTreeBuilder::SyntaxTreeBuilder()
 {
+	tokenizer = NULL;
 	script = new Script();
 }
 
@@ -27,6 +28,27 @@ SyntaxTreeBuilder::~SyntaxTreeBuilder()
 {
 }
 
+/**
+  The tokenizer gives the location of what is being built, which is
+  just after its last token.
+*/
+void SyntaxTreeBuilder::setTokenizer(AbstractTokenBuilder* t)
+{
+	tokenizer = t;
+}
+
+void SyntaxTreeBuilder::locate(Declaration* dec) const
+{
+	if(tokenizer)
+		dec->setLocation(tokenizer->getFileName(),tokenizer->getLineNumber());
+}
+
+void SyntaxTreeBuilder::locate(Expression* exp) const
+{
+	if(tokenizer)
+		exp->setLocation(tokenizer->getFileName(),tokenizer->getLineNumber());
+}
+
 void SyntaxTreeBuilder::buildScript(Declaration* dec)
 {
 	script->addDeclaration(dec);
@@ -144,6 +166,22 @@ QList<Declaration*>* SyntaxTreeBuilder::buildDeclarations(Declaration* decl)
 	return result;
 }
 
+QList<Declaration*>* SyntaxTreeBuilder::buildInclude(Script* inc)
+{
+	return buildInclude(new QList<Declaration*>(),inc);
+}
+
+QList<Declaration*>* SyntaxTreeBuilder::buildInclude(QList<Declaration*>* decls,Script* inc)
+{
+	script->addInclude(inc);
+	decls->append(inc->getDeclarations());
+	return decls;
+}
+
+void SyntaxTreeBuilder::buildIncludes(QList<QString>)
+{
+}
+
 Statement* SyntaxTreeBuilder::buildStatement(Statement* stmt)
 {
 	return stmt;
@@ -152,6 +190,7 @@ Statement* SyntaxTreeBuilder::buildStatement(Statement* stmt)
 Statement* SyntaxTreeBuilder::buildStatement(Variable* var,Expression::Operator_e op)
 {
 	AssignStatement* result = new AssignStatement();
+	locate(result);
 	result->setVariable(var);
 	result->setOperation(op);
 	return result;
@@ -160,6 +199,7 @@ Statement* SyntaxTreeBuilder::buildStatement(Variable* var,Expression::Operator_
 Statement* SyntaxTreeBuilder::buildStatement(Variable* var,Expression::Operator_e op,Expression* exp)
 {
 	AssignStatement* result = new AssignStatement();
+	locate(result);
 	result->setVariable(var);
 	result->setOperation(op);
 	result->setExpression(exp);
@@ -177,6 +217,7 @@ Statement* SyntaxTreeBuilder::buildStatement(QList<Statement*>* stmts)
 Statement* SyntaxTreeBuilder::buildStatement(Variable* var,Expression* exp)
 {
 	AssignStatement* result = new AssignStatement();
+	locate(result);
 	result->setVariable(var);
 	result->setExpression(exp);
 	return result;
@@ -185,7 +226,9 @@ Statement* SyntaxTreeBuilder::buildStatement(Variable* var,Expression* exp)
 Statement* SyntaxTreeBuilder::buildStatement(QString* name,Variable::StorageClass_e c, Expression* exp)
 {
 	AssignStatement* result = new AssignStatement();
+	locate(result);
 	Variable* var = new Variable();
+	locate(var);
 	var->setName(*name);
 	delete name;
 	var->setStorageClass(c);
@@ -197,6 +240,7 @@ Statement* SyntaxTreeBuilder::buildStatement(QString* name,Variable::StorageClas
 Statement* SyntaxTreeBuilder::buildReturnStatement(Expression* exp)
 {
 	ReturnStatement* result = new ReturnStatement();
+	locate(result);
 	result->setExpression(exp);
 	return result;
 }
@@ -204,6 +248,7 @@ Statement* SyntaxTreeBuilder::buildReturnStatement(Expression* exp)
 Statement* SyntaxTreeBuilder::buildIfElseStatement(Expression* expr,Statement* stmt)
 {
 	IfElseStatement* result = new IfElseStatement();
+	locate(result);
 	result->setExpression(expr);
 	result->setTrueStatement(stmt);
 	return result;
@@ -212,6 +257,7 @@ Statement* SyntaxTreeBuilder::buildIfElseStatement(Expression* expr,Statement* s
 Statement* SyntaxTreeBuilder::buildIfElseStatement(Expression* expr,Statement* truestmt ,Statement* falsestmt)
 {
 	IfElseStatement* result = new IfElseStatement();
+	locate(result);
 	result->setExpression(expr);
 	result->setTrueStatement(truestmt);
 	result->setFalseStatement(falsestmt);;
@@ -221,6 +267,7 @@ Statement* SyntaxTreeBuilder::buildIfElseStatement(Expression* expr,Statement* t
 Statement* SyntaxTreeBuilder::buildForStatement(QList<Argument*>* args,Statement* stmt)
 {
 	ForStatement* result = new ForStatement();
+	locate(result);
 	result->setArguments(*args);
 	delete args;
 	result->setStatement(stmt);
@@ -325,6 +372,7 @@ Instance* SyntaxTreeBuilder::buildInstance(Instance::Type_e type,Instance* inst)
 Instance* SyntaxTreeBuilder::buildInstance(QString* name,QList<Argument*>* args)
 {
 	Instance* result = new Instance();
+	locate(result);
 	result->setName(*name);
 	delete name;
 	result->setArguments(*args);
@@ -454,6 +502,7 @@ Expression* SyntaxTreeBuilder::buildLiteral(QString* value)
 Variable* SyntaxTreeBuilder::buildVariable(QString* name)
 {
 	Variable* result = new Variable();
+	locate(result);
 	result->setName(*name);
 	delete name;
 	return result;
@@ -467,6 +516,7 @@ Expression* SyntaxTreeBuilder::buildVariable(Variable* var)
 Variable* SyntaxTreeBuilder::buildVariable(QString* name,Variable::StorageClass_e c)
 {
 	Variable* result = new Variable();
+	locate(result);
 	result->setStorageClass(c);
 	result->setName(*name);
 	delete name;
@@ -478,6 +528,7 @@ Expression* SyntaxTreeBuilder::buildExpression(Expression* exp,QString* name)
 	BinaryExpression* result = new BinaryExpression();
 	result->setLeft(exp);
 	Variable* val = new Variable();
+	locate(val);
 	val->setName(*name);
 	delete name;
 	result->setRight(val);
@@ -519,6 +570,7 @@ Expression* SyntaxTreeBuilder::buildExpression(Expression* cond,Expression* true
 Expression* SyntaxTreeBuilder::buildExpression(QList<Expression*>* exps,int count)
 {
 	VectorExpression* result = new VectorExpression();
+	locate(result);
 	result->setChildren(*exps);
 	result->setAdditionalCommas(count);
 	delete exps;
@@ -551,6 +603,7 @@ QList<Expression*>* SyntaxTreeBuilder::buildVector(QList<Expression*>* exprs,uns
 Expression* SyntaxTreeBuilder::buildRange(Expression* srt,Expression* fin)
 {
 	RangeExpression* result = new RangeExpression();
+	locate(result);
 	result->setStart(srt);
 	result->setFinish(fin);
 	return result;
@@ -559,6 +612,7 @@ Expression* SyntaxTreeBuilder::buildRange(Expression* srt,Expression* fin)
 Expression* SyntaxTreeBuilder::buildRange(Expression* srt,Expression* stp,Expression* fin)
 {
 	RangeExpression* result = new RangeExpression();
+	locate(result);
 	result->setStart(srt);
 	result->setFinish(fin);
 	result->setStep(stp);
@@ -568,6 +622,7 @@ Expression* SyntaxTreeBuilder::buildRange(Expression* srt,Expression* stp,Expres
 Invocation* SyntaxTreeBuilder::buildInvocation(QString* name,QList<Argument*>* args)
 {
 	Invocation* result = new Invocation();
+	locate(result);
 	result->setName(*name);
 	delete name;
 	result->setArguments(*args);
@@ -39,12 +39,14 @@
 #include "rangeexpression.h"
 #include "invocation.h"
 #include "codedoc.h"
+#include "abstracttokenbuilder.h"
 
 class SyntaxTreeBuilder : public AbstractSyntaxTreeBuilder
 {
 public:
 	SyntaxTreeBuilder();
 	~SyntaxTreeBuilder();
+	void setTokenizer(AbstractTokenBuilder*);
 	void buildScript(Declaration*);
 	void buildScript(QList<Declaration*>*);
 	void buildScript(QList<CodeDoc*>*);
@@ -61,6 +63,9 @@ public:
 	QList<Declaration*>* buildDeclarations(Declaration*);
 	QList<Declaration*>* buildDeclarations(QList<Declaration*>*);
 	QList<Declaration*>* buildDeclarations(QList<Declaration*>*,Declaration*);
+	QList<Declaration*>* buildInclude(Script*);
+	QList<Declaration*>* buildInclude(QList<Declaration*>*,Script*);
+	void buildIncludes(QList<QString>);
 	Statement* buildStatement(Statement*);
 	Statement* buildStatement(Variable*,Expression::Operator_e);
 	Statement* buildStatement(Variable*,Expression::Operator_e,Expression*);
@@ -121,6 +126,9 @@ public:
 
 	Script* getResult() const;
 private:
+	void locate(Declaration*) const;
+	void locate(Expression*) const;
+	AbstractTokenBuilder* tokenizer;
 	Script* script;
 };
 
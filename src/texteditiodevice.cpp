@@ -16,14 +16,44 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
+#include <QTextCursor>
 #include "texteditiodevice.h"
 
-TextEditIODevice::TextEditIODevice(QTextEdit* textEdit,QObject* parent) :
+/* Output is gathered here and handed to the text edit in batches so that
+ scripts writing in a tight loop don't flood the GUI thread. */
+static const int UpdateInterval=100;
+
+TextEditIODevice::TextEditIODevice(QPlainTextEdit* textEdit,QObject* parent) :
 	QIODevice(parent)
 	, textEdit(textEdit)
 {
+	scheduled=false;
+	last.count=0;
+	maximumLines=0;
+	timer=new QTimer(this);
+	timer->setSingleShot(true);
+	timer->setInterval(UpdateInterval);
+	connect(timer,SIGNAL(timeout()),this,SLOT(writeTextEdit()));
+
 	open(QIODevice::WriteOnly|QIODevice::Text);
-	connect(this,SIGNAL(textRecieved(QString)),this,SLOT(writeTextEdit(QString)));
+	connect(this,SIGNAL(textRecieved()),this,SLOT(scheduleUpdate()));
+}
+
+TextEditIODevice::~TextEditIODevice()
+{
+	if(!partial.isEmpty()) {
+		appendLine(partial);
+		partial.clear();
+	}
+	writeTextEdit();
+}
+
+void TextEditIODevice::setMaximumLines(int lines)
+{
+	QMutexLocker locker(&lock);
+	maximumLines=lines;
+	textEdit->setMaximumBlockCount(lines);
 }
 
 qint64 TextEditIODevice::readData(char*,qint64)
@@ -33,11 +63,95 @@ qint64 TextEditIODevice::readData(char*,qint64)
 
 qint64 TextEditIODevice::writeData(const char* data, qint64 maxSize)
 {
-	emit textRecieved(data);
+	QMutexLocker locker(&lock);
+	partial.append(QString::fromLocal8Bit(data,maxSize));
+
+	//Only complete lines are written, the remainder waits for its newline.
+	QStringList lines=partial.split('\n');
+	partial=lines.takeLast();
+	foreach(QString line,lines) {
+		if(line.endsWith('\r'))
+			line.chop(1);
+		appendLine(line);
+	}
+
+	if(!scheduled && !pending.isEmpty()) {
+		scheduled=true;
+		emit textRecieved();
+	}
 	return maxSize;
 }
 
-void TextEditIODevice::writeTextEdit(QString data)
+void TextEditIODevice::appendLine(const QString& text)
 {
-	textEdit->append(data);
+	if(!pending.isEmpty()) {
+		Line& previous=pending.last();
+		if(previous.text==text && collapses(text)) {
+			previous.count++;
+			return;
+		}
+	}
+
+	Line l;
+	l.text=text;
+	l.count=1;
+	pending.append(l);
+
+	//Lines beyond the limit would be discarded by the text edit anyway.
+	if(maximumLines>0 && pending.size()>maximumLines)
+		pending.removeFirst();
+}
+
+bool TextEditIODevice::collapses(const QString& text)
+{
+	return text.startsWith("Warning:");
+}
+
+QString TextEditIODevice::lineText(const Line& l)
+{
+	if(l.count>1)
+		return QString("%1 %2%3").arg(l.text).arg(QChar(0x00D7)).arg(l.count);
+	return l.text;
+}
+
+void TextEditIODevice::scheduleUpdate()
+{
+	if(!timer->isActive())
+		timer->start();
+}
+
+void TextEditIODevice::writeTextEdit()
+{
+	QList<Line> lines;
+	lock.lock();
+	lines=pending;
+	pending.clear();
+	scheduled=false;
+	lock.unlock();
+
+	if(lines.isEmpty())
+		return;
+
+	if(textEdit->document()->isEmpty())
+		last.count=0;
+
+	/* A warning that repeats the last line already shown only updates
+	 the count on that line. */
+	Line first=lines.first();
+	if(last.count>0 && first.text==last.text && collapses(first.text)) {
+		last.count+=first.count;
+		QTextCursor cursor(textEdit->document());
+		cursor.movePosition(QTextCursor::End);
+		cursor.movePosition(QTextCursor::StartOfBlock,QTextCursor::KeepAnchor);
+		cursor.insertText(lineText(last));
+		lines.removeFirst();
+		if(lines.isEmpty())
+			return;
+	}
+
+	QStringList text;
+	foreach(Line l,lines)
+		text.append(lineText(l));
+	textEdit->appendPlainText(text.join("\n"));
+	last=lines.last();
 }
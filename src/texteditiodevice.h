@@ -16,26 +16,47 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+
 #ifndef TEXTEDITIODEVICE_H
 #define TEXTEDITIODEVICE_H
 
 #include <QIODevice>
-#include <QTextEdit>
+#include <QPlainTextEdit>
+#include <QMutex>
+#include <QTimer>
 
 class TextEditIODevice : public QIODevice
 {
 	Q_OBJECT
 public:
-	TextEditIODevice(QTextEdit*,QObject* parent = 0);
+	TextEditIODevice(QPlainTextEdit*,QObject* parent = 0);
+	~TextEditIODevice();
+	void setMaximumLines(int);
 signals:
-	void textRecieved(QString);
+	void textRecieved();
 protected:
 	qint64 readData(char*,qint64);
 	qint64 writeData(const char*,qint64);
 private slots:
-	void writeTextEdit(QString);
+	void scheduleUpdate();
+	void writeTextEdit();
 private:
-	QTextEdit* textEdit;
+	struct Line {
+		QString text;
+		int count;
+	};
+	void appendLine(const QString&);
+	static bool collapses(const QString&);
+	static QString lineText(const Line&);
+
+	QPlainTextEdit* textEdit;
+	QTimer* timer;
+	QMutex lock;
+	QList<Line> pending;
+	QString partial;
+	bool scheduled;
+	Line last;
+	int maximumLines;
 };
 
 #endif // TEXTEDITIODEVICE_H
@@ -22,6 +22,7 @@ TextValue::TextValue(QString value)
 {
 	this->text=value;
 	this->defined=true;
+	this->type=Text;
 }
 
 QString TextValue::getValueString() const
@@ -29,6 +30,11 @@ QString TextValue::getValueString() const
 	return this->text;
 }
 
+Value* TextValue::copy()
+{
+	return new TextValue(this->text);
+}
+
 bool TextValue::isTrue() const
 {
 	return !this->text.isEmpty();
@@ -26,6 +26,7 @@ class TextValue : public Value
 public:
 	TextValue(QString);
 	QString getValueString() const;
+	Value* copy();
 	bool isTrue() const;
 private:
 	Value* operation(Value&,Expression::Operator_e);
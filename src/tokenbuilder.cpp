@@ -18,28 +18,53 @@
 
 #include "tokenbuilder.h"
 #include "parser_yacc.h"
+#include "scriptcache.h"
 #define YY_NULL 0
-extern int lexerlex_destroy();
-extern void lexerinclude(const char*);
-extern void lexererror();
-extern int lexerlex();
-extern int lexerleng;
-extern int lexerlineno;
-
-TokenBuilder::TokenBuilder()
-{
+extern void* lexerinit(AbstractTokenBuilder*,Reporter*);
+extern void lexerinput(void*,QString,bool);
+extern void lexerdestroy(void*);
+extern void lexerinclude(void*,const char*);
+extern void lexererror(void*);
+extern int lexerlex(void*);
+extern int lexerget_leng(void*);
+extern int lexerget_lineno(void*);
+extern char* lexerget_text(void*);
+
+TokenBuilder::TokenBuilder(Reporter* r,QString input,bool file)
+{
+	reporter=r;
 	position=1;
+	depth=0;
+	value=NULL;
+	stringcontents=NULL;
+	scanner=lexerinit(this,r);
+	//Files included from text are found relative to the working directory
+	if(!file)
+		path_stack.push(QDir::current());
+	file_stack.push(file?QFileInfo(input).absoluteFilePath():QString());
+	lexerinput(scanner,input,file);
 }
 
 TokenBuilder::~TokenBuilder()
 {
-	lexerlex_destroy();
+	lexerdestroy(scanner);
+}
+
+int TokenBuilder::nextToken(YYSTYPE* v)
+{
+	value=v;
+	return nextToken();
 }
 
 int TokenBuilder::nextToken()
 {
-	position+=lexerleng;
-	return lexerlex();
+	position+=lexerget_leng(scanner);
+	return lexerlex(scanner);
+}
+
+QString TokenBuilder::getText() const
+{
+	return lexerget_text(scanner);
 }
 
 int TokenBuilder::getPosition() const
@@ -49,7 +74,25 @@ int TokenBuilder::getPosition() const
 
 int TokenBuilder::getLineNumber() const
 {
-	return lexerlineno;
+	return lexerget_lineno(scanner);
+}
+
+/**
+  The file being tokenized, which is an included file while it is being
+  read, or empty when tokenizing text.
+*/
+QString TokenBuilder::getFileName() const
+{
+	return file_stack.top();
+}
+
+/**
+  The paths of all the files included while tokenizing, whatever
+  their depth.
+*/
+QList<QString> TokenBuilder::getIncludes() const
+{
+	return includes;
 }
 
 void TokenBuilder::buildIncludeStart()
@@ -66,31 +109,40 @@ void TokenBuilder::buildIncludePath(QString str)
 	filepath = str;
 }
 
-void TokenBuilder::buildIncludeFinish()
+unsigned int TokenBuilder::buildIncludeFinish()
 {
 	if(filename.isEmpty())
-		return;
+		return YY_NULL;
 
 	QDir currentpath = path_stack.top();
-	if(filepath.isEmpty()) {
-		path_stack.push(currentpath);
-	} else {
+	if(!filepath.isEmpty()) {
 		QFileInfo dirinfo(currentpath,filepath);
-		path_stack.push(dirinfo.dir());
+		currentpath = dirinfo.dir();
 		filepath.clear();
 	}
 
-	currentpath = path_stack.top();
 	QFileInfo fileinfo(currentpath,filename);
-
-	if(!fileinfo.exists())
-		path_stack.pop();
-
 	filename.clear();
+	if(fileinfo.exists())
+		includes.append(fileinfo.absoluteFilePath());
+
+	/* Top level includes are parsed on their own so that the
+	 * resulting declarations can be shared through the cache,
+	 * anything nested inside braces is still included textually. */
+	if(depth==0 && fileinfo.exists()) {
+		ScriptCache* cache=ScriptCache::getInstance();
+		value->script = cache->getScript(fileinfo.absoluteFilePath(),reporter);
+		return INCLUDE;
+	}
 
-	const char* fullpath = fileinfo.absoluteFilePath().toLocal8Bit();
-	lexerinclude(fullpath);
+	if(fileinfo.exists()) {
+		path_stack.push(currentpath);
+		file_stack.push(fileinfo.absoluteFilePath());
+	}
 
+	QByteArray fullpath = fileinfo.absoluteFilePath().toLocal8Bit();
+	lexerinclude(scanner,fullpath.constData());
+	return YY_NULL;
 }
 
 void TokenBuilder::buildUseStart()
@@ -99,7 +151,10 @@ void TokenBuilder::buildUseStart()
 
 unsigned int TokenBuilder::buildUse(QString str)
 {
-	parserlval.text = new QString(str);
+	QFileInfo fileinfo(path_stack.top(),str);
+	if(fileinfo.exists())
+		str = fileinfo.absoluteFilePath();
+	value->text = new QString(str);
 	return USE;
 }
 
@@ -113,7 +168,10 @@ void TokenBuilder::buildImportStart()
 
 unsigned int TokenBuilder::buildImport(QString str)
 {
-	parserlval.text = new QString(str);
+	QFileInfo fileinfo(path_stack.top(),str);
+	if(fileinfo.exists())
+		str = fileinfo.absoluteFilePath();
+	value->text = new QString(str);
 	return IMPORT;
 }
 
@@ -308,24 +366,28 @@ unsigned int TokenBuilder::buildAppend()
 
 unsigned int TokenBuilder::buildLegalChar(unsigned int c)
 {
+	if(c=='{')
+		depth++;
+	else if(c=='}')
+		depth--;
 	return c;
 }
 
 unsigned int TokenBuilder::buildIllegalChar()
 {
-	lexererror();
+	lexererror(scanner);
 	return YY_NULL;
 }
 
 unsigned int TokenBuilder::buildNumber(QString str)
 {
-	parserlval.number = str.toDouble();
+	value->number = str.toDouble();
 	return NUMBER;
 }
 
 unsigned int TokenBuilder::buildIdentifier(QString str)
 {
-	parserlval.text = new QString(str);
+	value->text = new QString(str);
 	return IDENTIFIER;
 }
 
@@ -346,7 +408,7 @@ void TokenBuilder::buildString(QString s)
 
 unsigned int TokenBuilder::buildStringFinish()
 {
-	parserlval.text = stringcontents;
+	value->text = stringcontents;
 	return STRING;
 }
 
@@ -370,7 +432,7 @@ unsigned int TokenBuilder::buildCodeDocStart()
 
 unsigned int TokenBuilder::buildCodeDoc(QString s)
 {
-	parserlval.text = new QString(s.trimmed());
+	value->text = new QString(s.trimmed());
 	return DOCTEXT;
 }
 
@@ -380,7 +442,7 @@ void TokenBuilder::buildCodeDoc()
 
 unsigned int TokenBuilder::buildCodeDocParam(QString s)
 {
-	parserlval.text = new QString(s.trimmed());
+	value->text = new QString(s.trimmed());
 	return DOCPARAM;
 }
 
@@ -395,7 +457,7 @@ void TokenBuilder::buildWhiteSpaceError()
 
 void TokenBuilder::buildWhiteSpace()
 {
-	position+=lexerleng;
+	position+=lexerget_leng(scanner);
 }
 
 void TokenBuilder::buildNewLine()
@@ -411,4 +473,7 @@ void TokenBuilder::buildFileStart(QDir pth)
 void TokenBuilder::buildFileFinish()
 {
 	path_stack.pop();
+	//Errors at the very end are still reported against the input
+	if(file_stack.size()>1)
+		file_stack.pop();
 }
@@ -24,19 +24,24 @@
 #include <QStack>
 #include <QDir>
 #include "abstracttokenbuilder.h"
+#include "reporter.h"
 
 class TokenBuilder : public AbstractTokenBuilder
 {
 public:
-	TokenBuilder();
+	TokenBuilder(Reporter*,QString,bool);
 	~TokenBuilder();
+	int nextToken(union YYSTYPE*);
 	int nextToken();
+	QString getText() const;
 	int getPosition() const;
 	int getLineNumber() const;
+	QString getFileName() const;
+	QList<QString> getIncludes() const;
 	void buildIncludeStart();
 	void buildIncludeFile(QString);
 	void buildIncludePath(QString);
-	void buildIncludeFinish();
+	unsigned int buildIncludeFinish();
 	void buildUseStart();
 	unsigned int buildUse(QString);
 	void buildUseFinish();
@@ -102,11 +107,17 @@ public:
 	void buildFileStart(QDir);
 	void buildFileFinish();
 private:
+	void* scanner;
+	union YYSTYPE* value;
 	QString* stringcontents;
 	QString filename;
 	QString filepath;
 	QStack<QDir> path_stack;
+	QStack<QString> file_stack;
+	QList<QString> includes;
+	Reporter* reporter;
 	int position;
+	int depth;
 };
 
 #endif // TOKENBUILDER_H
@@ -16,29 +16,105 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QThread>
+#include <QQueue>
+#include <QtConcurrentRun>
+#include <math.h>
 #include "treeevaluator.h"
+#include "sideeffectchecker.h"
 #include "vectorvalue.h"
+#include "packedvectorvalue.h"
+#include "numbervalue.h"
+#include "booleanvalue.h"
 #include "rangevalue.h"
 #include "node/unionnode.h"
 #include "builtincreator.h"
 #include "module/importmodule.h"
 
-TreeEvaluator::TreeEvaluator(QTextStream& s) : output(s)
+TreeEvaluator::TreeEvaluator(QTextStream& s) : random(0), output(s)
 {
 	context=NULL;
+	sharedContext=NULL;
 	rootNode=NULL;
+	diagnostics=NULL;
+	values=Registry<Value>::current();
+	nodes=Registry<Node>::current();
+}
+
+TreeEvaluator::TreeEvaluator(QTextStream& s,Context* shared) : random(0), output(s)
+{
+	context=NULL;
+	sharedContext=shared;
+	rootNode=NULL;
+	diagnostics=NULL;
+	values=Registry<Value>::current();
+	nodes=Registry<Node>::current();
 }
 
 TreeEvaluator::~TreeEvaluator()
 {
+	if(sharedContext)
+		return;
+
 	Value::cleanup();
 	delete context;
+
+	foreach(ScriptLibrary* lib,libraries)
+		delete lib;
+}
+
+/**
+  Warnings and echoed text are reported to the given sink rather than
+  written out, so that nothing is formatted while evaluating.
+*/
+void TreeEvaluator::setDiagnostics(DiagnosticSink* d)
+{
+	diagnostics=d;
+}
+
+/**
+  Everything random in the evaluation follows from this seed, which is
+  also part of the key of any geometry cached from it.
+*/
+void TreeEvaluator::setSeed(quint64 s)
+{
+	random=Random(s);
+}
+
+quint64 TreeEvaluator::getSeed() const
+{
+	return random.getSeed();
+}
+
+void TreeEvaluator::report(Diagnostic* d)
+{
+	if(diagnostics) {
+		diagnostics->report(d);
+		return;
+	}
+	output << d->getMessage() << "\n";
+	delete d;
+}
+
+/* Warnings about part of the script give its location */
+void TreeEvaluator::report(Diagnostic* d,Declaration* dec)
+{
+	d->setLocation(dec->getSourceFile(),dec->getLineNumber());
+	report(d);
+}
+
+void TreeEvaluator::report(Diagnostic* d,Expression* exp)
+{
+	d->setLocation(exp->getSourceFile(),exp->getLineNumber());
+	report(d);
 }
 
 void TreeEvaluator::startContext(Scope* scp)
 {
 	Context* parent = context;
 	context = new Context(output);
+	context->setDiagnostics(diagnostics);
+	context->setSeed(parent?parent->nextSeed():random.split());
 	context->setParent(parent);
 	context->setCurrentScope(scp);
 	contextStack.push(context);
@@ -61,12 +137,16 @@ void TreeEvaluator::visit(ModuleScope* scp)
 	context->setArguments(arguments,parameters);
 	context->setInputNodes(childnodes);
 
+	//The declaration that returned, directly or from inside it
+	Declaration* returned=NULL;
 	foreach(Declaration* d, scp->getDeclarations()) {
 		d->accept(*this);
+		if(!returned && context->getReturnValue())
+			returned=d;
 	}
 
-	if(context->getReturnValue())
-		output << "Warning: return statement not valid inside module scope.\n";
+	if(returned)
+		report(new Diagnostic(Diagnostic::ModuleReturn),returned);
 
 	//"pop" our child nodes.
 	childnodes=context->getCurrentNodes();
@@ -78,7 +158,7 @@ void TreeEvaluator::visit(ModuleScope* scp)
 
 void TreeEvaluator::visit(Instance* inst)
 {
-	QString name = inst->getName();
+	int name = inst->getSymbol();
 
 	QList <Statement*> stmts = inst->getChildren();
 	if(stmts.size()>0) {
@@ -113,7 +193,7 @@ void TreeEvaluator::visit(Instance* inst)
 		context->clearArguments();
 		context->clearParameters();
 	} else {
-		output << "Warning: cannot find module '" << name << "'.\n";
+		report(new Diagnostic(Diagnostic::ModuleMissing,QStringList(inst->getName())),inst);
 	}
 }
 
@@ -186,25 +266,180 @@ void TreeEvaluator::visit(ForStatement* forstmt)
 		Value* first = args.at(0);
 		context->clearArguments();
 
+		//Each iteration is seeded by its index, however it is evaluated
+		quint64 loopSeed=context->nextSeed();
+		quint64 afterSeed=context->nextSeed();
+		if(!sharedContext && evaluateParallel(forstmt,first,loopSeed)) {
+			context->setSeed(afterSeed);
+			return;
+		}
+
+		int index=0;
 		Iterator<Value*>* i = first->createIterator();
 		for(i->first(); !i->isDone(); i->next()) {
 
-			Value* v = i->currentItem();
-			v->setName(first->getName());
+			Value* v = isolate(i->currentItem());
+			v->setSymbol(first->getSymbol());
 			context->setVariable(v);
+			context->setSeed(Random::derive(loopSeed,index++));
 
 			forstmt->getStatement()->accept(*this);
 
 		}
 		delete i;
+		context->setSeed(afterSeed);
 	} else {
 		forstmt->getStatement()->accept(*this);
 	}
 }
 
+/* Iterations that only produce nodes are evaluated by worker evaluators,
+ * each running a contiguous share of the iterations in a fresh context
+ * whose parent is the loop's context. Shares are taken straight from the
+ * iterator and only a few are in flight at once, so a long range is
+ * never expanded as a whole. The nodes and any warnings are gathered
+ * back in iteration order. */
+static const int MaxShare=64;
+
+bool TreeEvaluator::evaluateParallel(ForStatement* forstmt,Value* first,quint64 loopSeed)
+{
+	int threads=QThread::idealThreadCount();
+	if(threads<2)
+		return false;
+
+	SideEffectChecker checker(context);
+	if(checker.hasSideEffects(forstmt->getStatement()))
+		return false;
+
+	QList<Value*> items;
+	Iterator<Value*>* i = first->createIterator();
+	for(i->first(); !i->isDone() && items.size()<2; i->next())
+		items.append(i->currentItem());
+
+	if(items.size()<2) {
+		delete i;
+		return false;
+	}
+
+	//Split vectors and numeric ranges, whose size is cheap to get, evenly
+	int share=MaxShare;
+	VectorValue* vec=dynamic_cast<VectorValue*>(first);
+	RangeValue* range=dynamic_cast<RangeValue*>(first);
+	if(vec && (!range || range->isNumeric()))
+		share=qBound(1,(vec->size()+threads-1)/threads,MaxShare);
+
+	int symbol=first->getSymbol();
+	int index=0;
+	Value* last=NULL;
+	QQueue<Share*> pending;
+	while(true) {
+		for(; !i->isDone() && items.size()<share; i->next())
+			items.append(i->currentItem());
+		if(items.isEmpty())
+			break;
+
+		last=items.last();
+		pending.enqueue(startShare(forstmt,items,symbol,loopSeed,index));
+		index+=items.size();
+		items.clear();
+		if(pending.size()>=threads*2)
+			finishShare(pending.dequeue());
+	}
+	delete i;
+
+	while(!pending.isEmpty())
+		finishShare(pending.dequeue());
+
+	//Leave the loop variable as it would be after a serial loop
+	last->setSymbol(symbol);
+	context->setVariable(last);
+
+	return true;
+}
+
+TreeEvaluator::Share* TreeEvaluator::startShare(ForStatement* forstmt,QList<Value*> items,int symbol,quint64 loopSeed,int index)
+{
+	Share* s=new Share();
+	s->stream=new QTextStream(&s->buffer);
+	s->worker=new TreeEvaluator(*s->stream,context);
+	s->worker->parameters=parameters;
+	s->sink=NULL;
+	if(diagnostics) {
+		s->sink=new DiagnosticSink();
+		s->worker->setDiagnostics(s->sink);
+	}
+	s->result=QtConcurrent::run(s->worker,&TreeEvaluator::evaluateIterations,forstmt,items,symbol,loopSeed,index);
+	return s;
+}
+
+void TreeEvaluator::finishShare(Share* s)
+{
+	s->result.waitForFinished();
+	foreach(Node* n, s->result.result())
+		context->addCurrentNode(n);
+
+	s->stream->flush();
+	output << s->buffer;
+	//Keep the diagnostics in the order a serial loop would give
+	if(s->sink) {
+		foreach(Diagnostic* d,s->sink->takeAll())
+			diagnostics->report(d);
+		delete s->sink;
+	}
+	delete s->worker;
+	delete s->stream;
+	delete s;
+}
+
+QList<Node*> TreeEvaluator::evaluateIterations(ForStatement* forstmt,QList<Value*> items,int symbol,quint64 loopSeed,int index)
+{
+	//Whatever the iterations create belongs to the evaluation that spawned them
+	Registry<Value>* previousValues=Registry<Value>::attach(values);
+	Registry<Node>* previousNodes=Registry<Node>::attach(nodes);
+
+	QList<Node*> result;
+	foreach(Value* item, items) {
+		context=new Context(output);
+		context->setDiagnostics(diagnostics);
+		context->setSeed(Random::derive(loopSeed,index++));
+		context->setParent(sharedContext);
+		context->setCurrentScope(sharedContext->getCurrentScope());
+		context->setInputNodes(sharedContext->getInputNodes());
+		contextStack.push(context);
+
+		Value* v=isolate(item);
+		v->setSymbol(symbol);
+		context->setVariable(v);
+
+		forstmt->getStatement()->accept(*this);
+
+		result.append(context->getCurrentNodes());
+		contextStack.pop();
+		delete context;
+	}
+	context=NULL;
+
+	Registry<Value>::attach(previousValues);
+	Registry<Node>::attach(previousNodes);
+	return result;
+}
+
+/* Values handed out by the shared context can be in use by other
+ * workers, so workers only rename their own copies. */
+Value* TreeEvaluator::isolate(Value* v)
+{
+	if(!sharedContext)
+		return v;
+
+	Value* c=v->copy();
+	c->setSymbol(v->getSymbol());
+	c->setStorageClass(v->getStorageClass());
+	return c;
+}
+
 void TreeEvaluator::visit(Parameter* param)
 {
-	QString name = param->getName();
+	int name = param->getSymbol();
 
 	Value* v;
 	Expression* e = param->getExpression();
@@ -215,46 +450,234 @@ void TreeEvaluator::visit(Parameter* param)
 		v = new Value();
 	}
 
-	v->setName(name);
+	v = isolate(v);
+	v->setSymbol(name);
 	context->addParameter(v);
 }
 
+/* Operators nested in an expression pass numbers and booleans to each
+ * other inline, so that only the final result is allocated. */
 void TreeEvaluator::visit(BinaryExpression* exp)
 {
-	exp->getLeft()->accept(*this);
-	Value* left=context->getCurrentValue();
+	context->setCurrentValue(box(evaluateOperator(exp)));
+}
 
-	exp->getRight()->accept(*this);
-	Value* right=context->getCurrentValue();
+TreeEvaluator::Operand TreeEvaluator::evaluateOperand(Expression* exp)
+{
+	BinaryExpression* binary=dynamic_cast<BinaryExpression*>(exp);
+	if(binary)
+		return evaluateOperator(binary);
+	UnaryExpression* unary=dynamic_cast<UnaryExpression*>(exp);
+	if(unary)
+		return evaluateOperator(unary);
+
+	exp->accept(*this);
+	return unbox(context->getCurrentValue());
+}
+
+TreeEvaluator::Operand TreeEvaluator::evaluateOperator(BinaryExpression* exp)
+{
+	Operand left=evaluateOperand(exp->getLeft());
+	Operand right=evaluateOperand(exp->getRight());
 
-	Value* result = Value::operation(left,exp->getOp(),right);
+	Operand result;
+	if(operation(left,exp->getOp(),right,result))
+		return result;
 
-	context->setCurrentValue(result);
+	return unbox(Value::operation(box(left),exp->getOp(),box(right)));
+}
+
+TreeEvaluator::Operand TreeEvaluator::evaluateOperator(UnaryExpression* exp)
+{
+	Operand left=evaluateOperand(exp->getExpression());
+
+	Operand result;
+	if(operation(left,exp->getOp(),result))
+		return result;
+
+	return unbox(Value::operation(box(left),exp->getOp()));
+}
+
+TreeEvaluator::Operand TreeEvaluator::unbox(Value* v)
+{
+	Operand o;
+	o.type=v->getType();
+	o.number=0.0;
+	o.boolean=false;
+	o.value=v;
+	if(o.type==Value::Number)
+		o.number=static_cast<NumberValue*>(v)->getNumber();
+	else if(o.type==Value::Boolean)
+		o.boolean=v->isTrue();
+	return o;
+}
+
+Value* TreeEvaluator::box(const Operand& o)
+{
+	if(o.value)
+		return o.value;
+	if(o.type==Value::Boolean)
+		return new BooleanValue(o.boolean);
+	return new NumberValue(o.number);
+}
+
+TreeEvaluator::Operand TreeEvaluator::inlineNumber(double n)
+{
+	Operand o;
+	o.type=Value::Number;
+	o.number=n;
+	o.boolean=false;
+	o.value=NULL;
+	return o;
+}
+
+TreeEvaluator::Operand TreeEvaluator::inlineBoolean(bool b)
+{
+	Operand o;
+	o.type=Value::Boolean;
+	o.number=0.0;
+	o.boolean=b;
+	o.value=NULL;
+	return o;
+}
+
+/* The same results as NumberValue and BooleanValue give, for the
+ * operators between two numbers or two booleans that they handle
+ * directly. Anything else is left to the values. */
+bool TreeEvaluator::operation(const Operand& left,Expression::Operator_e e,const Operand& right,Operand& result)
+{
+	if(left.type==Value::Number && right.type==Value::Number) {
+		double l=left.number;
+		double r=right.number;
+		switch(e) {
+		case Expression::Exponent:
+			result=inlineNumber(pow(l,r));
+			return true;
+		case Expression::Multiply:
+			result=inlineNumber(l*r);
+			return true;
+		case Expression::Divide:
+			result=inlineNumber(l/r);
+			return true;
+		case Expression::Modulus:
+			result=inlineNumber(fmod(l,r));
+			return true;
+		case Expression::Add:
+			result=inlineNumber(l+r);
+			return true;
+		case Expression::Subtract:
+			result=inlineNumber(l-r);
+			return true;
+		case Expression::LessThan:
+			result=inlineBoolean(l<r);
+			return true;
+		case Expression::LessOrEqual:
+			result=inlineBoolean(l<=r);
+			return true;
+		case Expression::Equal:
+			result=inlineBoolean(l==r);
+			return true;
+		case Expression::NotEqual:
+			result=inlineBoolean(l!=r);
+			return true;
+		case Expression::GreaterOrEqual:
+			result=inlineBoolean(l>=r);
+			return true;
+		case Expression::GreaterThan:
+			result=inlineBoolean(l>r);
+			return true;
+		case Expression::LogicalAnd:
+			result=inlineBoolean(l&&r);
+			return true;
+		case Expression::LogicalOr:
+			result=inlineBoolean(l||r);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	if(left.type==Value::Boolean && right.type==Value::Boolean) {
+		bool l=left.boolean;
+		bool r=right.boolean;
+		switch(e) {
+		case Expression::Equal:
+			result=inlineBoolean(l==r);
+			return true;
+		case Expression::NotEqual:
+			result=inlineBoolean(l!=r);
+			return true;
+		case Expression::LogicalAnd:
+			result=inlineBoolean(l&&r);
+			return true;
+		case Expression::LogicalOr:
+			result=inlineBoolean(l||r);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool TreeEvaluator::operation(const Operand& left,Expression::Operator_e e,Operand& result)
+{
+	if(left.type==Value::Number) {
+		double l=left.number;
+		switch(e) {
+		case Expression::Add:
+			result=inlineNumber(l);
+			return true;
+		case Expression::Subtract:
+			result=inlineNumber(-l);
+			return true;
+		case Expression::Invert:
+			result=inlineNumber(!l);
+			return true;
+		case Expression::Increment:
+			result=inlineNumber(l+1);
+			return true;
+		case Expression::Decrement:
+			result=inlineNumber(l-1);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	if(left.type==Value::Boolean && e==Expression::Invert) {
+		result=inlineBoolean(!left.boolean);
+		return true;
+	}
+
+	return false;
 }
 
 void TreeEvaluator::visit(Argument* arg)
 {
-	QString name;
+	int name=0;
 	Variable::StorageClass_e c=Variable::Var;
 	Variable* var = arg->getVariable();
 	if(var) {
 		var->accept(*this);
-		name=context->getCurrentName();
+		name=context->getCurrentSymbol();
 		c=var->getStorageClass();
 	}
 
 	arg->getExpression()->accept(*this);
-	Value* v = context->getCurrentValue();
+	Value* v = isolate(context->getCurrentValue());
 
-	v->setName(name);
+	v->setSymbol(name);
 	v->setStorageClass(c); //TODO Investigate moving this to apply to all variables.
 	context->addArgument(v);
 }
 
 void TreeEvaluator::visit(AssignStatement* stmt)
 {
-	stmt->getVariable()->accept(*this);
-	QString name = context->getCurrentName();
+	Variable* var = stmt->getVariable();
+	var->accept(*this);
+	int name = context->getCurrentSymbol();
 
 	Value* lvalue = context->getCurrentValue();
 
@@ -266,6 +689,8 @@ void TreeEvaluator::visit(AssignStatement* stmt)
 		break;
 	default: {
 		Expression* expression = stmt->getExpression();
+		if(op==Expression::None && dynamic_cast<Script*>(context->getCurrentScope()))
+			expression = parameters.value(var->getName(),expression);
 		if(expression) {
 			expression->accept(*this);
 			result = context->getCurrentValue();
@@ -292,18 +717,19 @@ void TreeEvaluator::visit(AssignStatement* stmt)
 		break;
 	}
 
-	result->setName(name);
+	result = isolate(result);
+	result->setSymbol(name);
 	Variable::StorageClass_e c;
 	c=lvalue->getStorageClass();
 	result->setStorageClass(c);
 	switch(c) {
 	case Variable::Const:
 		if(!context->addVariable(result))
-			output << "Warning: Attempt to alter constant variable '" << name << "'\n";
+			report(new Diagnostic(Diagnostic::ConstantAltered,QStringList(var->getName())),stmt);
 		break;
 	case Variable::Param:
 		if(!context->addVariable(result))
-			output << "Warning: Attempt to alter parametric variable '" << name << "'\n";
+			report(new Diagnostic(Diagnostic::ParametricAltered,QStringList(var->getName())),stmt);
 		break;
 	default:
 		context->setVariable(result);
@@ -320,9 +746,11 @@ void TreeEvaluator::visit(VectorExpression* exp)
 	}
 	int commas=exp->getAdditionalCommas();
 	if(commas>0)
-		output << "Warning: " << commas << " additional comma(s) found at the end of vector expression.\n";
+		report(new Diagnostic(Diagnostic::AdditionalCommas,QStringList(QString::number(commas))),exp);
 
-	Value* v = new VectorValue(childvalues);
+	Value* v = PackedVectorValue::pack(childvalues);
+	if(!v)
+		v = new VectorValue(childvalues);
 	context->setCurrentValue(v);
 }
 
@@ -341,18 +769,20 @@ void TreeEvaluator::visit(RangeExpression* exp)
 	exp->getFinish()->accept(*this);
 	Value* finish=context->getCurrentValue();
 
-	Value* result = new RangeValue(start,increment,finish);
+	RangeValue* result = new RangeValue(start,increment,finish);
+	if(result->isLimited()) {
+		QStringList args(result->getValueString());
+		if(result->size()>0)
+			report(new Diagnostic(Diagnostic::RangeLimited,args << QString::number(result->size())),exp);
+		else
+			report(new Diagnostic(Diagnostic::RangeUndefined,args),exp);
+	}
 	context->setCurrentValue(result);
 }
 
 void TreeEvaluator::visit(UnaryExpression* exp)
 {
-	exp->getExpression()->accept(*this);
-	Value* left=context->getCurrentValue();
-
-	Value* result = Value::operation(left,exp->getOp());
-
-	context->setCurrentValue(result);
+	context->setCurrentValue(box(evaluateOperator(exp)));
 }
 
 void TreeEvaluator::visit(ReturnStatement* stmt)
@@ -375,8 +805,7 @@ void TreeEvaluator::visit(TernaryExpression* exp)
 
 void TreeEvaluator::visit(Invocation* stmt)
 {
-	QString name = stmt->getName();
-	Function* func = context->lookupFunction(name);
+	Function* func = context->lookupFunction(stmt->getSymbol());
 	if(func) {
 		foreach(Argument* arg, stmt->getArguments())
 			arg->accept(*this);
@@ -396,7 +825,7 @@ void TreeEvaluator::visit(Invocation* stmt)
 		context->clearArguments();
 		context->clearParameters();
 	} else {
-		output << "Warning: cannot find function '" << name << "'.\n";
+		report(new Diagnostic(Diagnostic::FunctionMissing,QStringList(stmt->getName())),stmt);
 	}
 }
 
@@ -409,9 +838,11 @@ void TreeEvaluator::visit(ModuleImport* imp)
 	context->addModule(mod);
 }
 
-void TreeEvaluator::visit(ScriptImport*)
+void TreeEvaluator::visit(ScriptImport* imp)
 {
-	//TODO
+	ScriptLibrary* lib=new ScriptLibrary(imp->getImport(),output);
+	libraries.append(lib);
+	context->addLibrary(lib);
 }
 
 void TreeEvaluator::visit(Literal* lit)
@@ -423,24 +854,24 @@ void TreeEvaluator::visit(Literal* lit)
 
 void TreeEvaluator::visit(Variable* var)
 {
-	QString name = var->getName();
+	int name = var->getSymbol();
 	Variable::StorageClass_e oldClass=var->getStorageClass();
 	Variable::StorageClass_e currentClass=oldClass;
 	Value* v=context->lookupVariable(name,currentClass);
 	if(currentClass!=oldClass)
 		switch(oldClass) {
 		case Variable::Const:
-			output << "Warning: Attempt to make previously non-constant variable '" << name << "' constant\n";
+			report(new Diagnostic(Diagnostic::ConstantRedeclared,QStringList(var->getName())),var);
 			break;
 		case Variable::Param:
-			output << "Warning: Attempt to make previously non-parametric variable '" << name << "' parametric\n";
+			report(new Diagnostic(Diagnostic::ParametricRedeclared,QStringList(var->getName())),var);
 			break;
 		default:
 			break;
 		}
 
 	context->setCurrentValue(v);
-	context->setCurrentName(name);
+	context->setCurrentSymbol(name);
 }
 
 Node* TreeEvaluator::createUnion(QList<Node*> childnodes)
@@ -460,17 +891,20 @@ void TreeEvaluator::visit(CodeDoc*)
 
 void TreeEvaluator::visit(Script* sc)
 {
-	BuiltinCreator* b=BuiltinCreator::getInstance(output);
+	BuiltinCreator* b=BuiltinCreator::getInstance();
 	b->initBuiltins(sc);
 
 	startContext(sc);
+	Declaration* returned=NULL;
 	foreach(Declaration* d, sc->getDeclarations()) {
 		d->accept(*this);
+		if(!returned && context->getReturnValue())
+			returned=d;
 	}
 	QList<Node*> childnodes=context->getCurrentNodes();
 
-	if(context->getReturnValue())
-		output << "Warning: return statement not valid inside global scope.\n";
+	if(returned)
+		report(new Diagnostic(Diagnostic::GlobalReturn),returned);
 
 	rootNode=createUnion(childnodes);
 
@@ -481,3 +915,12 @@ Node* TreeEvaluator::getRootNode() const
 {
 	return rootNode;
 }
+
+/**
+  Expressions that replace the ones assigned to the named variables
+  at the top level of the script, such as its parameters.
+*/
+void TreeEvaluator::setParameters(QHash<QString,Expression*> p)
+{
+	parameters=p;
+}
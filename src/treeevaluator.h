@@ -20,6 +20,7 @@
 #define TREEEVALUATOR_H
 
 #include <QStack>
+#include <QFuture>
 #include <QTextStream>
 #include "treevisitor.h"
 #include "script.h"
@@ -47,6 +48,7 @@
 #include "variable.h"
 #include "context.h"
 #include "value.h"
+#include "diagnosticsink.h"
 
 class TreeEvaluator : public TreeVisitor
 {
@@ -79,14 +81,58 @@ public:
 	void visit(Script*);
 
 	Node* getRootNode() const;
+	void setParameters(QHash<QString,Expression*>);
+	void setDiagnostics(DiagnosticSink*);
+	void setSeed(quint64);
+	quint64 getSeed() const;
 private:
+	TreeEvaluator(QTextStream&,Context*);
 	void startContext(Scope*);
 	void finishContext();
+	void report(Diagnostic*);
+	void report(Diagnostic*,Declaration*);
+	void report(Diagnostic*,Expression*);
 	Node* createUnion(QList<Node*>);
+	Value* isolate(Value*);
+	/* The result of an operator, held inline when it is a number or a
+	 * boolean and only boxed as a value when it is needed as one. */
+	struct Operand {
+		Value::Type_e type;
+		double number;
+		bool boolean;
+		Value* value;
+	};
+	Operand evaluateOperand(Expression*);
+	Operand evaluateOperator(BinaryExpression*);
+	Operand evaluateOperator(UnaryExpression*);
+	static Operand unbox(Value*);
+	static Value* box(const Operand&);
+	static Operand inlineNumber(double);
+	static Operand inlineBoolean(bool);
+	static bool operation(const Operand&,Expression::Operator_e,const Operand&,Operand&);
+	static bool operation(const Operand&,Expression::Operator_e,Operand&);
+	struct Share {
+		QString buffer;
+		QTextStream* stream;
+		TreeEvaluator* worker;
+		DiagnosticSink* sink;
+		QFuture<QList<Node*> > result;
+	};
+	bool evaluateParallel(ForStatement*,Value*,quint64);
+	Share* startShare(ForStatement*,QList<Value*>,int,quint64,int);
+	void finishShare(Share*);
+	QList<Node*> evaluateIterations(ForStatement*,QList<Value*>,int,quint64,int);
 
 	Context* context;
+	Context* sharedContext;
 	QStack<Context*> contextStack;
+	QList<ScriptLibrary*> libraries;
+	QHash<QString,Expression*> parameters;
+	Registry<Value>* values;
+	Registry<Node>* nodes;
 	Node* rootNode;
+	DiagnosticSink* diagnostics;
+	Random random;
 	QTextStream& output;
 };
 
@@ -21,28 +21,28 @@
 #include "valueiterator.h"
 #include "vectorvalue.h"
 #include "booleanvalue.h"
+#include "symboltable.h"
 
 Value::Value()
 {
+	this->symbol=0;
 	this->storageClass=Variable::Const;
 	this->defined=false;
-	values.append(this);
+	this->type=Undefined;
+	this->registry=Registry<Value>::current();
+	registry->add(this);
 }
 
 Value::~Value()
 {
-	values.removeAll(this);
+	registry->remove(this);
 }
 
 void Value::cleanup()
 {
-	foreach(Value* val, values) {
-		delete val;
-	}
+	Registry<Value>::current()->cleanup();
 }
 
-QList<Value*> Value::values;
-
 void Value::setStorageClass(Variable::StorageClass_e c)
 {
 	this->storageClass=c;
@@ -53,14 +53,29 @@ Variable::StorageClass_e Value::getStorageClass() const
 	return storageClass;
 }
 
-void Value::setName(QString name)
+void Value::setSymbol(int symbol)
+{
+	this->symbol = symbol;
+}
+
+int Value::getSymbol() const
 {
-	this->name = name;
+	return this->symbol;
 }
 
 QString Value::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+Value::Type_e Value::getType() const
+{
+	return this->type;
+}
+
+bool Value::isVector() const
+{
+	return this->type==Vector||this->type==PackedVector||this->type==Range;
 }
 
 QString Value::getValueString() const
@@ -68,6 +83,11 @@ QString Value::getValueString() const
 	return "undef";
 }
 
+Value* Value::copy()
+{
+	return new Value();
+}
+
 bool Value::isTrue() const
 {
 	return false;
@@ -211,6 +231,11 @@ Value* Value::operator!()
 	return operation(Expression::Invert);
 }
 
+Value* Value::operator[](Value& v)
+{
+	return operation(v,Expression::Index);
+}
+
 double Value::modulus(double left, double right)
 {
 	return fmod(left,right);
@@ -289,6 +314,8 @@ Value* Value::operation(Value* p_left, Expression::Operator_e e, Value* p_right)
 		return left&&right;
 	case Expression::LogicalOr:
 		return left||right;
+	case Expression::Index:
+		return left[right];
 	default:
 		return &left;
 	}
@@ -23,18 +23,32 @@
 #include "iterator.h"
 #include "expression.h"
 #include "variable.h"
+#include "registry.h"
 
 class Value
 {
 public:
+	enum Type_e {
+		Undefined,
+		Boolean,
+		Number,
+		Text,
+		Vector,
+		PackedVector,
+		Range
+	};
 	Value();
 	virtual ~Value();
 	static void cleanup();
 	void setStorageClass(Variable::StorageClass_e);
 	Variable::StorageClass_e getStorageClass() const;
-	void setName(QString);
+	void setSymbol(int);
+	int getSymbol() const;
 	QString getName() const;
+	Type_e getType() const;
+	bool isVector() const;
 	virtual QString getValueString() const;
+	virtual Value* copy();
 	virtual bool isTrue() const;
 	bool isDefined() const;
 	virtual class VectorValue* toVector(int);
@@ -64,11 +78,13 @@ public:
 	Value* operator&&(Value&);
 	Value* operator||(Value&);
 	Value* operator!();
+	Value* operator[](Value&);
 
 	static Value* operation(Value*,Expression::Operator_e);
 	static Value* operation(Value*,Expression::Operator_e,Value*);
 protected:
 	bool defined;
+	Type_e type;
 	bool isComparison(Expression::Operator_e);
 	template <class A, class B>
 	A basicOperation(B,Expression::Operator_e,B);
@@ -77,9 +93,9 @@ protected:
 	virtual Value* operation(Expression::Operator_e);
 	virtual Value* operation(Value&,Expression::Operator_e);
 private:
-	static QList<Value*> values;
+	Registry<Value>* registry;
 	Variable::StorageClass_e storageClass;
-	QString name;
+	int symbol;
 	template<class T>
 	T modulus(T left, T right);
 	double modulus(double left, double right);
@@ -17,9 +17,11 @@
  */
 
 #include "variable.h"
+#include "symboltable.h"
 
 Variable::Variable()
 {
+	symbol=0;
 	storageClass=Variable::Var;
 }
 
@@ -29,12 +31,17 @@ Variable::~Variable()
 
 QString Variable::getName() const
 {
-	return this->name;
+	return SymbolTable::getInstance()->lookup(this->symbol);
+}
+
+int Variable::getSymbol() const
+{
+	return this->symbol;
 }
 
 void Variable::setName(QString name)
 {
-	this->name = name;
+	this->symbol = SymbolTable::getInstance()->intern(name);
 }
 
 void Variable::setStorageClass(StorageClass_e c)
@@ -36,11 +36,12 @@ public:
 	~Variable();
 	void setName(QString);
 	QString getName() const;
+	int getSymbol() const;
 	void setStorageClass(StorageClass_e);
 	StorageClass_e getStorageClass() const;
 	void accept(TreeVisitor&);
 private:
-	QString name;
+	int symbol;
 	StorageClass_e storageClass;
 };
 
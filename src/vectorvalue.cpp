@@ -17,6 +17,7 @@
  */
 
 #include "vectorvalue.h"
+#include "packedvectorvalue.h"
 #include "numbervalue.h"
 #include "vectoriterator.h"
 #include "rangevalue.h"
@@ -24,12 +25,14 @@
 
 VectorValue::VectorValue()
 {
+	this->type=Vector;
 }
 
 VectorValue::VectorValue(QList<Value*> values)
 {
 	this->children=values;
 	this->defined=true;
+	this->type=Vector;
 }
 
 QString VectorValue::getValueString() const
@@ -45,6 +48,11 @@ QString VectorValue::getValueString() const
 	return result;
 }
 
+Value* VectorValue::copy()
+{
+	return new VectorValue(this->children);
+}
+
 bool VectorValue::isTrue() const
 {
 	return this->children.size()>0;
@@ -90,28 +98,51 @@ QList<Value*> VectorValue::getChildren()
 	return this->children;
 }
 
+int VectorValue::size()
+{
+	return this->getChildren().size();
+}
+
+Value* VectorValue::getIndex(int i)
+{
+	QList<Value*> a=this->getChildren();
+	if(i<0||i>=a.size())
+		return new Value();
+	return a.at(i);
+}
+
 Value* VectorValue::operation(Expression::Operator_e e)
 {
+	QList<Value*> a=this->getChildren();
 	QList<Value*> result;
-	for(int i=0; i<this->children.size(); i++)
-		result.append(Value::operation(this->children.at(i),e));
+	for(int i=0; i<a.size(); i++)
+		result.append(Value::operation(a.at(i),e));
 	return new VectorValue(result);
 }
 
 Value* VectorValue::operation(Value& v, Expression::Operator_e e)
 {
+	if(e==Expression::Index) {
+		if(v.getType()==Number)
+			return this->getIndex(static_cast<NumberValue*>(&v)->getNumber());
+		return new Value();
+	}
+
 	QList<Value*> result;
-	VectorValue* vec=dynamic_cast<VectorValue*>(&v);
-	if(vec) {
+	if(v.isVector()) {
+		VectorValue* vec=static_cast<VectorValue*>(&v);
 		QList<Value*> a=this->getChildren();
 		QList<Value*> b=vec->getChildren();
 
 		if(e==Expression::OuterProduct) {
 			for(int i=0; i<b.size(); i++)
 				result.append(Value::operation(this,e,b.at(i)));
-		} else if(e==Expression::Multiply || e==Expression::Divide) {
-			//TODO implement multiply and divide
-			return this;
+		} else if(e==Expression::Multiply) {
+			PackedVectorValue* pa=PackedVectorValue::pack(a);
+			PackedVectorValue* pb=PackedVectorValue::pack(b);
+			if(pa && pb)
+				return Value::operation(pa,e,pb);
+			return new Value();
 		} else if(e==Expression::Concatenate) {
 			result=a;
 			result.append(b);
@@ -136,8 +167,8 @@ Value* VectorValue::operation(Value& v, Expression::Operator_e e)
 		return new VectorValue(result);
 	}
 
-	NumberValue* num = dynamic_cast<NumberValue*>(&v);
-	if(num) {
+	if(v.getType()==Number) {
+		NumberValue* num = static_cast<NumberValue*>(&v);
 		QList<Value*> a=this->getChildren();
 		if(e==Expression::Concatenate) {
 			result=a;
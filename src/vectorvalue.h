@@ -28,17 +28,20 @@ class VectorValue : public Value
 public:
 	VectorValue(QList<Value*>);
 	QString getValueString() const;
+	Value* copy();
 	bool isTrue() const;
 	VectorValue* toVector(int);
-	Point getPoint() const;
+	virtual Point getPoint() const;
 	Iterator<Value*>* createIterator();
 	virtual QList<Value*> getChildren();
+	virtual int size();
+	virtual Value* getIndex(int);
 protected:
 	VectorValue();
-private:
 	Value* operation(Expression::Operator_e);
 	Value* operation(Value&,Expression::Operator_e);
 	Expression::Operator_e convertOperation(Expression::Operator_e);
+private:
 	QList<Value*> children;
 };
 
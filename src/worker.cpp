@@ -17,12 +17,20 @@
  */
 
 #include <QTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QtConcurrentRun>
+#include <cstdio>
 #include "worker.h"
 #include "script.h"
 #include "treeprinter.h"
 #include "treeevaluator.h"
 #include "nodeprinter.h"
 #include "nodeevaluator.h"
+#include "nodededuplicator.h"
+#include "nodeprofile.h"
+#include "previewbuilder.h"
 
 #if USE_CGAL
 #include "CGAL/exceptions.h"
@@ -37,6 +45,13 @@ Worker::Worker(QTextStream& s, QObject* parent) :
 	output(s)
 {
 	reporter=new Reporter(output);
+	reporter->setDiagnostics(&diagnostics);
+	geometry=NULL;
+	geometryLock=NULL;
+	image=NULL;
+	exported=false;
+	progressive=false;
+	detach=false;
 }
 
 Worker::~Worker()
@@ -51,17 +66,117 @@ void Worker::setup(QString i,QString o,bool p)
 	print=p;
 }
 
+/**
+  Write a trace of the render that can be loaded in chrome://tracing
+*/
+void Worker::setTraceFile(QString f)
+{
+	traceFile=f;
+}
+
+void Worker::setGeometryCache(GeometryCache* g)
+{
+	geometry=g;
+}
+
+/**
+  Also render the result to the given PNG file
+*/
+void Worker::setImage(QString f,ImageRenderer* r)
+{
+	imageFile=f;
+	image=r;
+}
+
+/**
+  Workers running at the same time share a lock so that only one of
+  them computes geometry at once. CGAL's exact kernel and Nef
+  polyhedra can't be used from several threads unless CGAL was built
+  with CGAL_HAS_THREADS, which can't be relied on.
+*/
+void Worker::setGeometryLock(QMutex* l)
+{
+	geometryLock=l;
+}
+
+/**
+  Also write the warnings and errors to the given file as JSON, one
+  object per line.
+*/
+void Worker::setDiagnosticsFile(QString f)
+{
+	diagnosticsFile=f;
+}
+
+static void writeJson(QList<Diagnostic*> all,QTextStream* json)
+{
+	foreach(Diagnostic* d,all) {
+		if(json && d->getCode()!=Diagnostic::Echo)
+			*json << d->toJson() << "\n";
+		delete d;
+	}
+}
+
+/**
+  Writes out the warnings and echoed text reported since the last call.
+  The evaluation only records them, they are formatted here between
+  stages and the JSON is written on another thread while the next stage
+  runs.
+*/
+void Worker::reportDiagnostics(QTextStream* json)
+{
+	QList<Diagnostic*> all=diagnostics.takeAll();
+	foreach(Diagnostic* d,all) {
+		output << d->getMessage();
+		if(d->getCode()!=Diagnostic::Echo)
+			output << "\n";
+	}
+
+	logging.waitForFinished();
+	logging=QtConcurrent::run(writeJson,all,json);
+}
+
+bool Worker::isExported() const
+{
+	return exported;
+}
+
 void Worker::evaluate()
 {
+	cancelled=0;
 	doWork();
 }
 
+/**
+  Can be called from any thread to stop the rendering at its next
+  checkpoint. Subtrees that have already been rendered are kept in the
+  geometry cache.
+*/
+void Worker::cancel()
+{
+	cancelled=1;
+}
+
 void Worker::doWork()
 {
 	QTime* t = new QTime();
 	t->start();
+	NodeProfile profile;
+
+	QFile log(diagnosticsFile);
+	QTextStream logStream(&log);
+	QTextStream* json=NULL;
+	if(!diagnosticsFile.isEmpty()) {
+		if(log.open(QIODevice::WriteOnly|QIODevice::Truncate|QIODevice::Text))
+			json=&logStream;
+		else
+			output << "Warning: cannot write diagnostics '" << diagnosticsFile << "'\n";
+	}
 
+	profile.startStage("Parse");
 	Script* s=parse(inputFile,reporter);
+	profile.finishStage();
+	reportDiagnostics(json);
 
 	if(print) {
 		TreePrinter p(output);
@@ -69,9 +184,13 @@ void Worker::doWork()
 		output.flush();
 	}
 
+	profile.startStage("Evaluation");
 	TreeEvaluator e(output);
+	e.setDiagnostics(&diagnostics);
 	s->accept(e);
 	delete s;
+	profile.finishStage();
+	reportDiagnostics(json);
 	output.flush();
 
 	Node* n = e.getRootNode();
@@ -81,10 +200,49 @@ void Worker::doWork()
 		output.flush();
 	}
 
+	profile.startStage("Deduplication");
+	NodeDeduplicator d;
+	d.setSeed(e.getSeed());
+	n=d.deduplicate(n);
+	profile.finishStage();
+	int duplicates=d.getDuplicateCount();
+	if(duplicates>0)
+		output << "Deduplicated " << duplicates << " nodes.\n";
+	int instances=d.getInstanceCount();
+	if(instances>0)
+		output << "Instanced " << instances << " transformed nodes.\n";
+
+	//Held until the result has been exported and handed on
+	if(geometryLock)
+		geometryLock->lock();
+
 	NodeEvaluator ne(output);
+	ne.setReferences(d.getReferences());
+	if(geometry) {
+		ne.setDigests(d.getDigests());
+		ne.setGeometryCache(geometry);
+	}
+	if(print || !traceFile.isEmpty())
+		ne.setProfile(&profile);
+	ne.setCancelled(&cancelled);
+	ne.setDiagnostics(&diagnostics);
+
+	/* Show the primitives straight away and then the subtrees as they
+	 * get rendered. */
+	PreviewBuilder* builder=NULL;
+	if(progressive) {
+		builder=new PreviewBuilder(n);
+		connect(builder,SIGNAL(updated(Renderer*)),this,SIGNAL(preview(Renderer*)));
+		builder->update();
+		ne.setListener(builder);
+	}
+
+	bool stopped=false;
+	profile.startStage("Rendering");
 	try {
-		n->accept(ne);
-		delete n;
+		ne.evaluate(n);
+	} catch(CancelledException) {
+		stopped=true;
 #if USE_CGAL
 	} catch(CGAL::Assertion_exception e) {
 		output << "What: " << QString::fromStdString(e.what()) << "\n";
@@ -93,13 +251,53 @@ void Worker::doWork()
 	} catch(...) {
 	}
 #endif
+	profile.finishStage();
+	reportDiagnostics(json);
 
-	Primitive* result=ne.getResult();
-	if(!result)
+	if(print) {
+		profile.printTree(output,n);
+		output.flush();
+	}
+	delete builder;
+	delete n;
+
+	Primitive* result=stopped?NULL:ne.getResult();
+	exported=false;
+	if(stopped)
+		output << "Rendering stopped.\n";
+	else if(!result)
 		output << "Warning: No top level object.\n";
-	else if(!outputFile.isEmpty()) {
-		exportResult(result,outputFile);
+
+#if USE_CGAL
+	//The file and the image are made from one conversion of the result
+	CGALPrimitive* cp=dynamic_cast<CGALPrimitive*>(result);
+	if(cp && (!outputFile.isEmpty() || image)) {
+		CGALExport exporter(cp);
+		if(!outputFile.isEmpty()) {
+			profile.startStage("Export");
+			exported=exportFile(exporter,outputFile);
+			profile.finishStage();
+		}
+		if(image) {
+			profile.startStage("Image");
+			QVector<double> vertices;
+			QVector<int> triangles;
+			exporter.exportMesh(vertices,triangles);
+			if(!ImageRenderer::isAvailable())
+				output << "Warning: this build cannot render images without a display.\n";
+			else if(!image->render(vertices,triangles,imageFile))
+				output << "Warning: cannot write image '" << imageFile << "'\n";
+			profile.finishStage();
+		}
 	}
+#endif
+
+	if(print)
+		profile.printStages(output);
+	if(!traceFile.isEmpty() && !profile.writeTrace(traceFile))
+		output << "Warning: cannot write trace '" << traceFile << "'\n";
+
+	logging.waitForFinished();
 
 	int ticks=t->elapsed();
 	int ms=ticks%1000;
@@ -109,7 +307,17 @@ void Worker::doWork()
 	output.flush();
 	delete t; //Need to delete t before finish() call.
 
+#if USE_CGAL
+	//The result shares its representation with the cached geometry
+	if(geometry && detach && cp) {
+		result=cp->deepCopy();
+		delete cp;
+	}
+#endif
+
 	emit done(result);
+	if(geometryLock)
+		geometryLock->unlock();
 
 	finish();
 }
@@ -118,17 +326,40 @@ void Worker::finish()
 {
 }
 
-void Worker::exportResult(Primitive* primitive, QString fn)
+bool Worker::exportResult(Primitive* primitive, QString fn)
 {
 #if USE_CGAL
 	CGALPrimitive* p = dynamic_cast<CGALPrimitive*>(primitive);
 	if(p) {
 		CGALExport exporter(p);
-		exporter.exportResult(fn);
+		return exportFile(exporter,fn);
 	}
 #endif
+	return false;
 }
 
+#if USE_CGAL
+/* The result is written next to the file and then renamed over it, so
+ * that anything watching the file never sees it partially written. */
+bool Worker::exportFile(CGALExport& exporter, QString fn)
+{
+	QFileInfo info(fn);
+	QString temp=info.dir().filePath("."+info.completeBaseName()+".part."+info.suffix());
+	exporter.exportResult(temp);
+	if(!QFile::exists(temp))
+		return false;
+	if(std::rename(QFile::encodeName(temp).constData(),QFile::encodeName(fn).constData())!=0) {
+		//Renaming over an existing file is not allowed everywhere
+		QFile::remove(fn);
+		if(!QFile::rename(temp,fn)) {
+			QFile::remove(temp);
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
 Renderer* Worker::getRenderer(Primitive* primitive)
 {
 #if USE_CGAL
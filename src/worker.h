@@ -20,10 +20,18 @@
 #define WORKER_H
 
 #include <QObject>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QFuture>
 #include <QTextStream>
 #include "primitive.h"
 #include "renderer.h"
 #include "reporter.h"
+#include "diagnosticsink.h"
+#include "geometrycache.h"
+#include "imagerenderer.h"
+
+class CGALExport;
 
 class Worker : public QObject
 {
@@ -31,22 +39,45 @@ class Worker : public QObject
 public:
 	Worker(QTextStream&,QObject* parent = 0);
 	void setup(QString,QString,bool);
+	void setTraceFile(QString);
+	void setGeometryCache(GeometryCache*);
+	void setImage(QString,ImageRenderer*);
+	void setDiagnosticsFile(QString);
+	void setGeometryLock(QMutex*);
 	virtual void evaluate();
-	void exportResult(Primitive*,QString);
+	void cancel();
+	bool exportResult(Primitive*,QString);
+	bool isExported() const;
 	Renderer* getRenderer(Primitive*);
 	virtual ~Worker();
 signals:
 	void done(Primitive*);
+	void preview(Renderer*);
 protected slots:
 	void doWork();
 protected:
 	virtual void finish();
 	QString inputFile;
 	QString outputFile;
+	QString traceFile;
+	QString imageFile;
+	QString diagnosticsFile;
 	bool print;
+	bool progressive;
+	//The result is handed to another thread
+	bool detach;
+	QAtomicInt cancelled;
 private:
+	void reportDiagnostics(QTextStream*);
+	bool exportFile(CGALExport&,QString);
 	QTextStream& output;
 	Reporter* reporter;
+	DiagnosticSink diagnostics;
+	QFuture<void> logging;
+	GeometryCache* geometry;
+	QMutex* geometryLock;
+	ImageRenderer* image;
+	bool exported;
 };
 
 #endif // WORKER_H
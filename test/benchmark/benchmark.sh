@@ -0,0 +1,121 @@
+#!/bin/bash
+# Runs the benchmark scripts through the command line pipeline several
+# times and compares the median time of each stage, and the peak memory,
+# against the baseline. Stages are read from the trace written by -t,
+# peak memory is measured with GNU time when it is available. Without a
+# baseline nothing can be compared, which is reported as a failure.
+#
+# usage: benchmark.sh [-u] [-r runs] [-t tolerance] [rapcad]
+#   -u  record the results as the new baseline
+#   -r  number of runs of each script, 5 by default
+#   -t  allowed slowdown in percent, 10 by default
+
+dir=$(cd "$(dirname "$0")" && pwd)
+baseline=$dir/baseline.txt
+scripts="union-parts deep-transforms large-import long-loop minkowski hull"
+runs=5
+tolerance=10
+#Differences smaller than this many microseconds are noise
+slack=20000
+update=false
+
+while getopts "ur:t:" opt; do
+	case $opt in
+	u) update=true ;;
+	r) runs=$OPTARG ;;
+	t) tolerance=$OPTARG ;;
+	*) exit 2 ;;
+	esac
+done
+shift $((OPTIND-1))
+rapcad=${1:-$dir/../../rapcad}
+
+if [ ! -x "$rapcad" ]; then
+	echo "Cannot run '$rapcad'"
+	exit 2
+fi
+
+timer=""
+if /usr/bin/time -f %M true > /dev/null 2>&1; then
+	timer="/usr/bin/time -f %M -o"
+fi
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cp "$dir"/*.rcad "$work"
+if ! "$rapcad" -o "$work/large-import.stl" "$work/large-model.rcad" > /dev/null; then
+	echo "Cannot build large-model"
+	exit 1
+fi
+
+median(){
+	sort -n | awk '{v[NR]=$1} END {if(NR) print v[int((NR+1)/2)]}'
+}
+
+for script in $scripts; do
+	echo "Running $script"
+	rm -f "$work"/$script.*.values
+	for ((run=0; run<runs; run++)); do
+		#A trace left by an earlier run must never be read as this one
+		rm -f "$work/trace.json"
+		if [ -n "$timer" ]; then
+			$timer "$work/rss" "$rapcad" -o "$work/out.stl" -t "$work/trace.json" "$work/$script.rcad" > /dev/null
+		else
+			"$rapcad" -o "$work/out.stl" -t "$work/trace.json" "$work/$script.rcad" > /dev/null
+		fi
+		status=$?
+		if [ $status -ne 0 ] || [ ! -f "$work/trace.json" ]; then
+			echo "$script failed with status $status"
+			exit 1
+		fi
+		if [ -n "$timer" ]; then
+			cat "$work/rss" >> "$work/$script.PeakMemory.values"
+		fi
+		sed -n 's/.*"name":"\([^"]*\)","cat":"stage".*"dur":\([0-9]*\).*/\1 \2/p' "$work/trace.json" |
+		while read stage duration; do
+			echo $duration >> "$work/$script.$stage.values"
+		done
+	done
+	for values in "$work"/$script.*.values; do
+		metric=$(basename "$values" .values)
+		echo "$metric $(median < "$values")"
+	done >> "$work/results.txt"
+done
+
+if $update; then
+	cp "$work/results.txt" "$baseline"
+	echo "Baseline written to $baseline"
+	exit 0
+fi
+
+if [ ! -f "$baseline" ]; then
+	cat "$work/results.txt"
+	echo "No baseline to compare with, record one with -u"
+	exit 3
+fi
+
+#Times are in microseconds and memory in kilobytes
+awk -v tolerance=$tolerance -v slack=$slack '
+	NR==FNR { base[$1]=$2; next }
+	{
+		seen[$1]=1
+		status="ok"
+		known=($1 in base)
+		limit=base[$1]*(1+tolerance/100)
+		if(!known)
+			status="new"
+		else if($2>limit && $2-base[$1]>slack)
+			status="SLOWER"
+		if(status=="SLOWER")
+			failed++
+		printf "%-40s %12s %12s  %s\n", $1, base[$1], $2, status
+	}
+	END {
+		for(metric in base)
+			if(!(metric in seen)) {
+				printf "%-40s %12s %12s  %s\n", metric, base[metric], "", "MISSING"
+				failed++
+			}
+		if(failed) { print failed " regressions"; exit 1 }
+	}
+' "$baseline" "$work/results.txt"